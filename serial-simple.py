@@ -2,13 +2,34 @@
 """
 Simple script to send a string over serial to Arduino at 115200 baud.
 Usage: python3 serial-simple.py "your text here"
+
+It can also stream raw frames with the binary frame protocol
+(see src/FrameProtocol.h):
+Usage: python3 serial-simple.py --stream frames.bin [--size 84x16] [--fps 10]
+
+frames.bin holds back-to-back frames in the BROSE9323 buffer layout:
+rows of (width + 7) // 8 bytes, bit 0 of a byte is its leftmost pixel.
+Use - to read frames from stdin.
+
+--port DEVICE skips the port search in both modes.
 """
 
+import argparse
+import binascii
 import serial
 import serial.tools.list_ports
 import time
 import sys
 
+FRAME_SYNC = 0xA5
+FRAME_FULL = 0x01
+FRAME_DELTA = 0x02
+FRAME_KEY_RLE = 0x03
+FRAME_HELLO = 0x04
+FRAME_ACK = 0x10
+FRAME_OK = 0
+FRAME_STATUS_NAMES = ['ok', 'pending', 'bad crc', 'bad length', 'bad type']
+
 def find_arduino_port():
     """Find the Arduino USB serial port."""
     ports = serial.tools.list_ports.comports()
@@ -39,11 +60,143 @@ def find_arduino_port():
     print("No Arduino found. Please check USB connection.")
     return None
 
-def send_string(text_to_send):
+def build_message(msg_type, seq, payload):
+    """Frame a message: SYNC, type, sequence, length, payload, CRC-16/CCITT."""
+    body = bytes([msg_type, seq & 0xFF, len(payload) & 0xFF, len(payload) >> 8]) + bytes(payload)
+    crc = binascii.crc_hqx(body, 0xFFFF)
+    return bytes([FRAME_SYNC]) + body + bytes([crc & 0xFF, crc >> 8])
+
+
+def encode_rle(prev, frame):
+    """RLE of prev XOR frame (frame alone if prev is None), see FrameProtocol.h."""
+    diff = bytes(a ^ b for a, b in zip(prev, frame)) if prev is not None else bytes(frame)
+    out = bytearray()
+    i = 0
+    while i < len(diff):
+        run = 0
+        if diff[i]:
+            # A single unchanged byte is cheaper inside a literal run
+            while (i + run < len(diff) and run < 128 and
+                   (diff[i + run] or (i + run + 1 < len(diff) and diff[i + run + 1]))):
+                run += 1
+            out.append(0x80 | (run - 1))
+            out += diff[i:i + run]
+        else:
+            while i + run < len(diff) and run < 128 and not diff[i + run]:
+                run += 1
+            if i + run == len(diff):
+                break
+            out.append(run - 1)
+        i += run
+    return bytes(out)
+
+
+def read_ack(ser, seq, timeout=5.0):
+    """Wait for the ACK of message seq, returns its status or None on timeout.
+
+    ACKs for earlier messages that come in late are skipped."""
+    deadline = time.time() + timeout
+    state = bytearray()
+    while time.time() < deadline:
+        c = ser.read(1)
+        if not c:
+            continue
+        if not state and c[0] != FRAME_SYNC:
+            continue
+        state += c
+        if len(state) >= 5:
+            length = state[3] | (state[4] << 8)
+            if len(state) == 5 + length + 2:
+                body = bytes(state[1:5 + length])
+                crc = state[-2] | (state[-1] << 8)
+                msg_type = state[1]
+                state = bytearray()
+                if crc != binascii.crc_hqx(body, 0xFFFF) or msg_type != FRAME_ACK or body[1] != seq & 0xFF:
+                    continue
+                return body[4]
+    return None
+
+
+def open_port(port_name):
+    """Open the Arduino serial port and wait for the board to reset."""
+    ser = serial.Serial()
+    ser.baudrate = 115200
+    ser.port = port_name
+    ser.writeTimeout = 0.2
+    ser.timeout = 1  # Add timeout for reading
+
+    # Wait for connection to stabilize
+    time.sleep(1)
+
+    ser.open()
+    print("Serial connection opened successfully")
+
+    time.sleep(2)
+    # Flush existing serial buffers
+    ser.reset_input_buffer()
+    ser.reset_output_buffer()
+    print("Serial buffers flushed")
+    return ser
+
+
+def read_frames(source, frame_size):
+    """Yield frames of frame_size bytes from a file or stdin."""
+    stream = sys.stdin.buffer if source == '-' else open(source, 'rb')
+    try:
+        while True:
+            frame = stream.read(frame_size)
+            if len(frame) < frame_size:
+                return
+            yield frame
+    finally:
+        if stream is not sys.stdin.buffer:
+            stream.close()
+
+
+def stream_frames(ser, source, width, height, fps):
+    """Send frames as delta or key frames, one at a time, waiting for each ACK."""
+    frame_size = (width + 7) // 8 * height
+    seq = 0
+    ser.write(build_message(FRAME_HELLO, seq, b''))
+    if read_ack(ser, seq) != FRAME_OK:
+        print("Controller did not answer, is the frame receiver running?")
+        return
+
+    prev = None
+    frames = raw_bytes = sent_bytes = 0
+    for frame in read_frames(source, frame_size):
+        start = time.time()
+        while True:
+            candidates = [(FRAME_FULL, frame), (FRAME_KEY_RLE, encode_rle(None, frame))]
+            if prev is not None:
+                candidates.append((FRAME_DELTA, encode_rle(prev, frame)))
+            msg_type, payload = min(candidates, key=lambda c: len(c[1]))
+            seq += 1
+            message = build_message(msg_type, seq, payload)
+            ser.write(message)
+            status = read_ack(ser, seq)
+            sent_bytes += len(message)
+            if status == FRAME_OK:
+                break
+            # The controller's buffer is unknown now, resend as key frame
+            print(f"Frame {frames}: {FRAME_STATUS_NAMES[status] if status is not None else 'timeout'}, resending")
+            prev = None
+        prev = frame
+        frames += 1
+        raw_bytes += frame_size + 7
+        if fps:
+            time.sleep(max(0.0, 1.0 / fps - (time.time() - start)))
+
+    if frames:
+        print(f"Sent {frames} frames, {sent_bytes} bytes instead of {raw_bytes} "
+              f"({100.0 * sent_bytes / raw_bytes:.1f}%)")
+
+
+def send_string(text_to_send, port=None):
     """Send a string to the Arduino."""
     try:
         # Find Arduino port
-        arduino_port = find_arduino_port()
+        arduino_port = port or find_arduino_port()
         if not arduino_port:
             print("No Arduino found. Please check USB connection.")
             return
@@ -51,29 +204,12 @@ def send_string(text_to_send):
         print(f"Attempting to connect to {arduino_port}...")
 
         # Open serial connection
-        ser = serial.Serial()
-        ser.baudrate = 115200
-        ser.port = arduino_port
-        ser.writeTimeout = 0.2
-        ser.timeout = 1  # Add timeout for reading
-
-        # Wait for connection to stabilize
-        time.sleep(1)
-
         try:
-            ser.open()
-            print("Serial connection opened successfully")
+            ser = open_port(arduino_port)
         except Exception as e:
             print(f"Failed to open serial connection: {e}")
             return
 
-
-        time.sleep(2)
-        # Flush existing serial buffers
-        ser.reset_input_buffer()
-        ser.reset_output_buffer()
-        print("Serial buffers flushed")
-
         # Send the string - match Arduino IDE Serial Monitor exactly
         message = text_to_send + '\r\n'  # Add carriage return and newline
         print(f"Sending: '{message.strip()}'")
@@ -116,10 +252,46 @@ def send_string(text_to_send):
         import traceback
         traceback.print_exc()
 
+def send_stream(source, size, fps, port=None):
+    """Stream frames to the Arduino."""
+    try:
+        width, height = (int(v) for v in size.lower().split('x'))
+    except ValueError:
+        print(f"Invalid size '{size}', expected WIDTHxHEIGHT")
+        return
+
+    arduino_port = port or find_arduino_port()
+    if not arduino_port:
+        return
+
+    try:
+        ser = open_port(arduino_port)
+    except Exception as e:
+        print(f"Failed to open serial connection: {e}")
+        return
+
+    try:
+        stream_frames(ser, source, width, height, fps)
+    except serial.SerialException as e:
+        print(f"Serial error: {e}")
+    finally:
+        ser.close()
+        print("Serial connection closed")
+
+
 def main():
     """Main function to handle command line arguments."""
-    if len(sys.argv) != 2:
+    parser = argparse.ArgumentParser(description="Send text or stream frames to the flip-dot controller.")
+    parser.add_argument('text', nargs='?', help="text to scroll over the display")
+    parser.add_argument('--stream', metavar='FILE', help="stream raw frames from FILE (- for stdin)")
+    parser.add_argument('--size', default='84x16', help="display size as WIDTHxHEIGHT (default 84x16)")
+    parser.add_argument('--fps', type=float, default=0, help="limit the frame rate (default: as fast as acked)")
+    parser.add_argument('--port', metavar='DEVICE', help="serial port (default: search for the Arduino)")
+    args = parser.parse_args()
+
+    if (args.text is None) == (args.stream is None):
         print("Usage: python3 serial-simple.py \"your text here\"")
+        print("       python3 serial-simple.py --stream frames.bin")
         print("Example: python3 serial-simple.py \"Hello Arduino!\"")
         sys.exit(1)
 
@@ -132,8 +304,10 @@ def main():
     except:
         pass
 
-    text_to_send = sys.argv[1]
-    send_string(text_to_send)
+    if args.stream is not None:
+        send_stream(args.stream, args.size, args.fps, args.port)
+    else:
+        send_string(args.text, args.port)
 
 if __name__ == "__main__":
     main()
@@ -0,0 +1,148 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include "Effect.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+// On the host an animation is an ordinary array
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#endif
+
+// Pre-encoded animations in flash, made by the host tool
+// src/host/flipanim.cpp from a sequence of images:
+//
+//   WIDTH | HEIGHT | FRAMES_LO | FRAMES_HI | FRAME...
+//
+// and every frame
+//
+//   MS_LO | MS_HI | LEN_LO | LEN_HI | PAYLOAD[LEN]
+//
+// MS is how long the frame stays, in milliseconds. Bit 15 of it
+// (ANIMATION_KEY) marks a key frame, which is the RLE of the frame itself,
+// any other frame is the RLE of its XOR with the frame before. The first
+// frame is a key frame.
+//
+// A frame is a sequence of column words, left to right, of (height + 7) / 8
+// bytes each; bit (y & 7) of byte y / 8 of a column word is the dot in row
+// y. Payloads are RLE tokens over these bytes, as in the RLE payloads of the
+// frame protocol (src/FrameProtocol.h): a token 0x00-0x7F skips n + 1
+// bytes, a token 0x80-0xFF is followed by (n & 0x7F) + 1 literal bytes that
+// are XORed into the frame, a cleared one for a key frame.
+
+#define ANIMATION_HEADER_SIZE       4
+#define ANIMATION_FRAME_HEADER_SIZE 4
+#define ANIMATION_KEY               0x8000
+
+// Plays an animation from flash. Each tick() decodes one frame straight
+// into the canvas' buffer through getColumnByte()/setColumnByte(), and only
+// the columns a frame really changes are passed to markDirty(). There is
+// no intermediate frame. An animation of another size than the canvas
+// shows nothing.
+template <class Canvas>
+class AnimationEffect : public Effect {
+	private:
+		Canvas& _canvas;
+		const uint8_t* const _animation;
+		const bool _loop;
+		const uint8_t* _frame;   // header of the next frame
+		uint16_t _left;          // frames not shown yet
+
+		uint16_t _word(const uint8_t* p) {
+			return pgm_read_byte(p) | pgm_read_byte(p + 1) << 8;
+		}
+
+		bool _fits(void) {
+			return pgm_read_byte(_animation) == _canvas.width() && pgm_read_byte(_animation + 1) == _canvas.height();
+		}
+
+		void _rewind(void) {
+			_frame = _animation + ANIMATION_HEADER_SIZE;
+			_left = _word(_animation + 2);
+		}
+
+		// Sets byte i of column x, a column is passed to markDirty() once per
+		// frame and only if it really changes
+		void _put(uint8_t x, uint8_t i, uint8_t bits, int16_t& dirty) {
+			if (_canvas.getColumnByte(x, i) == bits) return;
+			_canvas.setColumnByte(x, i, bits);
+			if (dirty != x) {
+				_canvas.markDirty(x, 1);
+				dirty = x;
+			}
+		}
+
+		// Applies the tokens of one payload. A key frame is written over the
+		// frame before instead of clearing it first, so a key frame that
+		// looks like the frame before costs no more flips than a delta.
+		void _apply(const uint8_t* p, uint16_t len, bool key) {
+			const uint8_t column_size = (_canvas.height() + 7) / 8;
+			const uint8_t* const end = p + len;
+			uint8_t x = 0;
+			uint8_t i = 0;
+			int16_t dirty = -1;  // last column passed to markDirty()
+			while (x < _canvas.width()) {
+				uint8_t token = 0x7F;  // past the payload the rest is skipped
+				if (p < end) {
+					token = pgm_read_byte(p++);
+				} else if (!key) {
+					break;
+				}
+				if (!(token & 0x80) && !key) {
+					const uint16_t pos = x * column_size + i + token + 1;
+					x = pos / column_size;
+					i = pos % column_size;
+					continue;
+				}
+				for (uint8_t run = (token & 0x7F) + 1; run > 0 && x < _canvas.width(); run--) {
+					if (token & 0x80) {
+						const uint8_t bits = p < end ? pgm_read_byte(p++) : 0;
+						_put(x, i, key ? bits : _canvas.getColumnByte(x, i) ^ bits, dirty);
+					} else {
+						_put(x, i, 0, dirty);
+					}
+					if (++i == column_size) {
+						i = 0;
+						x++;
+					}
+				}
+			}
+		}
+	public:
+		// animation is in flash. A looping animation starts over after its
+		// last frame, otherwise the effect ends there.
+		AnimationEffect(Canvas& canvas, const char* name, const uint8_t* animation, bool loop = true) :
+			Effect(name, 100), _canvas(canvas), _animation(animation), _loop(loop) {}
+
+		void begin(void) {
+			_rewind();
+			// The scheduler reads frameMs() before tick(), so it always holds
+			// the time of the frame tick() draws next
+			_frame_ms = _left ? _word(_frame) & ~ANIMATION_KEY : 100;
+		}
+
+		bool tick(unsigned long) {
+			if (!_fits()) return false;
+			if (!_left) {
+				if (!_loop) return false;
+				_rewind();
+				if (!_left) return false;
+			}
+
+			const uint16_t ms = _word(_frame);
+			const uint16_t len = _word(_frame + 2);
+			_apply(_frame + ANIMATION_FRAME_HEADER_SIZE, len, ms & ANIMATION_KEY);
+			_frame += ANIMATION_FRAME_HEADER_SIZE + len;
+			_left--;
+
+			if (_left) {
+				_frame_ms = _word(_frame) & ~ANIMATION_KEY;
+			} else if (_loop) {
+				_frame_ms = _word(_animation + ANIMATION_HEADER_SIZE) & ~ANIMATION_KEY;
+			}
+			return _left || _loop;
+		}
+};
+#endif //ANIMATION_H
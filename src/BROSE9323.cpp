@@ -1,20 +1,37 @@
 #include <BROSE9323.h>
 
 BROSE9323::BROSE9323(uint8_t w, uint8_t h, uint8_t pw, uint16_t ft) :
+	BROSE9323(w, h, pw, ft, (uint8_t*) malloc(BROSE9323_STORAGE_SIZE(w, h))) {
+}
+
+BROSE9323::BROSE9323(uint8_t w, uint8_t h, uint8_t pw, uint16_t ft, uint8_t* storage) :
 	Adafruit_GFX(w, h),
 	_flip_time(ft),
 	_panel_width(pw),
 	_buffer_width((w + 7) / 8),
-	_buffer_size(_buffer_width * h) {
-	// Buffer width should fit at least [width] bits
-	//_buffer_width = (w + 7) / 8;
-	
-	//_buffer_size = _buffer_width * h;
+	_buffer_size(BROSE9323_BUFFER_SIZE(w, h)) {
+	memset(storage, 0, BROSE9323_STORAGE_SIZE(w, h));
 
+	_new_buffer = storage;
+	storage += _buffer_size;
 #if !defined(__AVR_ATmega168P__) && !defined(__AVR_ATmega168PB__) && !defined(__AVR_ATmega168__)
-	_old_buffer = (uint8_t*) calloc(_buffer_size, sizeof(uint8_t));
+	_old_buffer = storage;
+	storage += _buffer_size;
+#endif
+#ifdef ESP8266
+	_frame = storage;
+#else
+#ifdef BROSE9323_ASYNC
+	_target_buffer = storage;
+	storage += _buffer_size;
+#endif
+	// One bit per column, same bit order as a buffer row
+	_dirty = storage;
+	_walk_dirty = storage + _buffer_width;
+#endif
+#ifdef BROSE9323_COUNTERS
+	resetCounters();
 #endif
-	_new_buffer = (uint8_t*) calloc(_buffer_size, sizeof(uint8_t));
 }
 
 #ifdef ESP8266
@@ -63,6 +80,12 @@ void BROSE9323::begin(void) {
 	pinMode(ENABLE, OUTPUT);
 	_setData(1);
 	_setData(0);
+#if defined(BROSE9323_ASYNC) && defined(__AVR__)
+	// Timer1 drives the flip engine, its clock only runs while a frame is flipped
+	TCCR1A = 0;
+	TCCR1B = 0;
+	TIMSK1 = _BV(OCIE1A);
+#endif
 	//fillScreen(1);
 	//display();
 	//fillScreen(0);
@@ -71,122 +94,1023 @@ void BROSE9323::begin(void) {
 }
 #endif
 
+#if defined(BROSE9323_ASYNC) && defined(__AVR__)
+// Timer1 runs in CTC mode with a prescaler of 8
+#define BROSE9323_TIMER_TICKS_PER_US (F_CPU / 8000000UL)
+
+static BROSE9323* _engine_display = NULL;
+
+ISR(TIMER1_COMPA_vect) {
+	uint16_t us = _engine_display->tick();
+	if (us) {
+		OCR1A = us * BROSE9323_TIMER_TICKS_PER_US - 1;
+	} else {
+		TCCR1B = 0;
+	}
+}
+#endif
+
 void BROSE9323::display(bool force) {
+#ifdef BROSE9323_COUNTERS
+	const uint32_t start = micros();
+#endif
 #ifdef ESP8266
-	stream->print("D\n");
-	stream->flush();
+	// Only one message is in flight, the controller acknowledges it once
+	// the dots are flipped
+	_waitAck();
+	uint8_t* payload = _frame + FRAME_HEADER_SIZE;
+	uint16_t len = frameEncodeColumns(force || _resync ? NULL : _old_buffer, _new_buffer, width(), height(), payload);
+	if (len > _buffer_width) {
+		stream->write(_frame, frameBuild(FRAME_COLUMNS, ++_seq, payload, len, _frame));
+		memcpy(_old_buffer, _new_buffer, _buffer_size);
+		_ack_pending = true;
+		_resync = false;
+	}
 #else
-	if (_direct_mode) return;
-	for (uint8_t x = 0; x < width(); x++) {
-		_selectPanel(x / _panel_width);
-		
-		_selectColumn(x % _panel_width);
-		
-		for (uint8_t y = 0; y < height(); y++) {
-			bool b = _new_buffer[y * _buffer_width + x / 8] & (1 << (x & 7));
-#if !defined(__AVR_ATmega168P__) && !defined(__AVR_ATmega168PB__) && !defined(__AVR_ATmega168__)
-			if (!force && (bool)(_old_buffer[y * _buffer_width + x / 8] & (1 << (x & 7))) == b) {
-				continue;
-			}
+	// With a flip limit even the direct mode can leave dots for later
+	if (_direct_mode && !_flip_limit) {
+#ifdef BROSE9323_COUNTERS
+		_countDisplay(start);
 #endif
-			
-			_selectRow(y);
-			
-			_setData(_new_buffer[y * _buffer_width + x / 8] & (1 << (x & 7)));
-			
+		return;
+	}
+#ifdef BROSE9323_ASYNC
+	// Hand a snapshot of the frame to the flip engine. A frame that is still
+	// being flipped is replaced, the engine continues towards the new one.
+	// With a flip limit it continues the walk it is on, the dots drawn since
+	// are left for the next walk.
+	noInterrupts();
+	memcpy(_target_buffer, _new_buffer, _buffer_size);
+	if (force || !_flip_limit || !_walk_active) {
+		_mergeDirty();
+		_resetCursor(_cursor, force);
+		_walk_active = true;
+	}
+	_engine_budget = _flip_limit;
+	if (_engine_state == ENGINE_IDLE) {
+		_engine_state = ENGINE_NEXT;
+#ifdef __AVR__
+		_engine_display = this;
+		TCNT1 = 0;
+		OCR1A = BROSE9323_TIMER_TICKS_PER_US;
+		TIFR1 = _BV(OCF1A);
+		TCCR1B = _BV(WGM12) | _BV(CS11);
+#endif
+	}
+	interrupts();
+#else
+	if (_flip_limit) {
+		// Continue the walk displayStep() is on, a forced refresh starts over
+		// with every dot
+		if (force) {
+			_mergeDirty();
+			_resetCursor(_cursor, true);
+			_walk_active = true;
+		}
+		for (uint16_t n = 0; n < _flip_limit && displayStep(); n++);
+	} else {
+		_mergeDirty();
+		_resetCursor(_cursor, force);
+		uint8_t x, y;
+		bool b;
+		while (_nextFlip(_cursor, _new_buffer, x, y, b)) {
+			_startConverge();
+			_selectDot(x, y, b);
 			_strobe();
+			_commitDot(x, y, b);
 		}
+		_finishWalk();
+		_walk_active = false;
+		_converged();
 	}
-#if !defined(__AVR_ATmega168P__) && !defined(__AVR_ATmega168PB__) && !defined(__AVR_ATmega168__)
-	// Store currently displayed content in old buffer
-	memcpy(_old_buffer, _new_buffer, _buffer_size);
 #endif
 #endif
+#ifdef BROSE9323_COUNTERS
+	_countDisplay(start);
+#endif
 }
 
-void BROSE9323::drawPixel(int16_t x, int16_t y, uint16_t color) {
+#ifdef BROSE9323_COUNTERS
+void BROSE9323::_countDisplay(uint32_t start) {
+	const uint32_t us = micros() - start;
+	_counters.displays++;
+	_counters.display_us_sum += us;
+	if (us < _counters.display_us_min) _counters.display_us_min = us;
+	if (us > _counters.display_us_max) _counters.display_us_max = us;
+}
+
+// The flip engine counts from its interrupt, so copy and reset with
+// interrupts off
+BROSE9323::Counters BROSE9323::counters(void) {
+#ifdef BROSE9323_ASYNC
+	noInterrupts();
+#endif
+	const Counters counters = _counters;
+#ifdef BROSE9323_ASYNC
+	interrupts();
+#endif
+	return counters;
+}
+
+void BROSE9323::resetCounters(void) {
+#ifdef BROSE9323_ASYNC
+	noInterrupts();
+#endif
+	memset(&_counters, 0, sizeof(_counters));
+	_counters.display_us_min = 0xFFFFFFFF;
+#ifdef BROSE9323_ASYNC
+	interrupts();
+#endif
+}
+#endif
+
 #ifdef ESP8266
-	char s[10];
-	sprintf(s, "%c%02x%02x%d\n", _direct_mode ? 'S' : 's', x, y, (bool)color);
-	stream->print(s);
-	stream->flush();
+void BROSE9323::_waitAck(void) {
+	if (!_ack_pending) return;
+	_ack_pending = false;
+
+	uint8_t ack[FRAME_OVERHEAD + 2];
+	uint8_t n = 0;
+	uint32_t start = millis();
+	while (millis() - start < BROSE9323_ACK_TIMEOUT) {
+		if (stream->available() <= 0) {
+			yield();
+			continue;
+		}
+		ack[n] = stream->read();
+		if (n > 0 || ack[0] == FRAME_SYNC) n++;
+		if (n < sizeof(ack)) continue;
+		n = 0;
+
+		uint16_t crc = 0xFFFF;
+		for (uint8_t i = 1; i < FRAME_HEADER_SIZE + 2; i++) {
+			crc = frameCrc16(crc, ack[i]);
+		}
+		const bool intact = ack[1] == FRAME_ACK &&
+			crc == (ack[FRAME_HEADER_SIZE + 2] | (uint16_t)ack[FRAME_HEADER_SIZE + 3] << 8);
+		// A late ACK for a message that timed out, keep waiting for ours
+		if (intact && ack[2] != _seq) continue;
+		// Anything but a good ACK leaves the controller's buffer unknown
+		if (!intact || ack[FRAME_HEADER_SIZE] != FRAME_OK) _resync = true;
+		return;
+	}
+	_resync = true;
+}
+#endif
+
+#ifndef ESP8266
+// Commits pending flips until the next one would exceed the budget.
+// Returns the number of flips still pending.
+uint16_t BROSE9323::displayFor(uint32_t budget_us) {
+	uint32_t start = micros();
+#ifdef BROSE9323_ASYNC
+	display();
+	while (busy() && micros() - start < budget_us);
 #else
-	if (y >= height() || y < 0 || x >= width() || x < 0) return;
-	if (color) {
-		if (_new_buffer[y * _buffer_width + x / 8] & (1 << (x & 7))) {
-			return;
+	const uint32_t flip_us = 4UL * _flip_time;
+	while (micros() - start + flip_us <= budget_us) {
+		if (!displayStep()) break;
+	}
+#endif
+	return pending();
+}
+
+#ifndef BROSE9323_ASYNC
+// Flips a single pending dot, continuing where the last call stopped.
+// Returns false if there was nothing left to flip.
+bool BROSE9323::displayStep(void) {
+	if (_direct_mode && !_flip_limit) return false;
+	uint8_t x, y;
+	bool b;
+	if (!_walk_active) {
+		_mergeDirty();
+		_resetCursor(_cursor, false);
+		_walk_active = true;
+	}
+	while (!_nextFlip(_cursor, _new_buffer, x, y, b)) {
+		// Walk done, start over if something was drawn in the meantime
+		_finishWalk();
+		_walk_active = false;
+		if (!_drawnSinceWalk()) {
+			_converged();
+			return false;
 		}
-		_new_buffer[y * _buffer_width + x / 8] |= 1 << (x & 7);
-	} else {
-		if (~_new_buffer[y * _buffer_width + x / 8] & (1 << (x & 7))) {
-			return;
+		_mergeDirty();
+		_resetCursor(_cursor, false);
+		_walk_active = true;
+	}
+	_startConverge();
+	_selectDot(x, y, b);
+	_strobe();
+	_commitDot(x, y, b);
+	return true;
+}
+#endif
+
+uint16_t BROSE9323::pending(void) {
+	return planFlips().strobes;
+}
+
+void BROSE9323::setFlipLimit(uint16_t limit) {
+#ifdef BROSE9323_ASYNC
+	noInterrupts();
+#endif
+	_flip_limit = limit;
+#ifdef BROSE9323_ASYNC
+	interrupts();
+#endif
+}
+
+uint16_t BROSE9323::getFlipLimit(void) {
+	return _flip_limit;
+}
+
+uint32_t BROSE9323::convergenceMicros(void) {
+#ifdef BROSE9323_ASYNC
+	noInterrupts();
+#endif
+	const uint32_t us = _converge_us;
+#ifdef BROSE9323_ASYNC
+	interrupts();
+#endif
+	return us;
+}
+
+// The panel fell behind the buffer, unless it already was
+void BROSE9323::_startConverge(void) {
+	if (_converging) return;
+	_converging = true;
+	_converge_start = micros();
+}
+
+// The panel caught up with the buffer
+void BROSE9323::_converged(void) {
+	if (!_converging) return;
+	_converging = false;
+	_converge_us = micros() - _converge_start;
+}
+#endif
+
+#ifndef ESP8266
+#ifdef BROSE9323_ASYNC
+bool BROSE9323::busy(void) {
+	return _engine_state != ENGINE_IDLE;
+}
+
+void BROSE9323::waitIdle(void) {
+	while (busy());
+}
+
+void BROSE9323::onFrameCommitted(void (*callback)(void)) {
+	_frame_committed = callback;
+}
+
+// One step of the flip engine, called from the timer ISR. Each dot takes
+// the same ENABLE sequence as _strobe(): low for _flip_time, high for
+// twice that, low again for _flip_time. Returns the microseconds until the
+// next step, or 0 once the frame is on the panel.
+uint16_t BROSE9323::tick(void) {
+	switch (_engine_state) {
+		case ENGINE_PULSE_1:
+			_setEnable(1);
+			_engine_state = ENGINE_GAP;
+			return _flip_time * 2;
+		case ENGINE_GAP:
+			_setEnable(0);
+			_engine_state = ENGINE_PULSE_2;
+			return _flip_time;
+		case ENGINE_PULSE_2:
+			_setEnable(1);
+			_commitDot(_engine_x, _engine_y, _engine_data);
+			BROSE9323_COUNT(strobes, 1);
+			// fall through
+		case ENGINE_NEXT:
+			if (_flip_limit && !_engine_budget) {
+				// The rest of the walk waits for the next display()
+				_engine_state = ENGINE_IDLE;
+				return 0;
+			}
+			_cursor.steps = BROSE9323_SCAN_STEPS;
+			_cursor.paused = false;
+			if (!_nextFlip(_cursor, _target_buffer, _engine_x, _engine_y, _engine_data)) {
+				if (_cursor.paused) {
+					_engine_state = ENGINE_NEXT;
+					return BROSE9323_SCAN_PAUSE;
+				}
+				_finishWalk();
+				_walk_active = false;
+				if (!_drawnSinceWalk()) _converged();
+				_engine_state = ENGINE_IDLE;
+				if (_frame_committed) _frame_committed();
+				return 0;
+			}
+			_startConverge();
+			if (_flip_limit) _engine_budget--;
+			_selectDot(_engine_x, _engine_y, _engine_data);
+			_setEnable(0);
+			_engine_state = ENGINE_PULSE_1;
+			return _flip_time;
+		case ENGINE_IDLE:
+			break;
+	}
+	return 0;
+}
+#endif
+
+BROSE9323::FlipPlanStats BROSE9323::planFlips(bool force) {
+	FlipPlanStats stats = {0, 0};
+	uint8_t lines_panel = _active_panel;
+	uint8_t lines_col = _active_col;
+	uint8_t lines_row = _active_row;
+	bool lines_data = _active_data;
+	FlipCursor cursor;
+	uint8_t x, y;
+	bool b;
+
+	_resetCursor(cursor, force);
+	cursor.drawn = true;
+	while (_nextFlip(cursor, _new_buffer, x, y, b)) {
+		uint8_t panel, col, row;
+		_dotAddress(x, y, panel, col, row);
+		stats.strobes++;
+		stats.transitions += __builtin_popcount((lines_panel ^ panel) & 0x07) +
+			__builtin_popcount((lines_col ^ col) & 0x1F) +
+			__builtin_popcount((lines_row ^ row) & 0x1F) +
+			(lines_data != b ? 3 : 0);
+		lines_panel = panel;
+		lines_col = col;
+		lines_row = row;
+		lines_data = b;
+	}
+	return stats;
+}
+
+void BROSE9323::setScanOrder(ScanOrder order) {
+	_scan_order = order;
+}
+
+// Moves the columns drawn to into the set walked by the flip plan
+void BROSE9323::_mergeDirty(void) {
+	for (uint8_t i = 0; i < _buffer_width; i++) {
+		_walk_dirty[i] |= _dirty[i];
+		_dirty[i] = 0;
+	}
+#ifdef BROSE9323_CHANGE_LOG
+	_log_walk = _log_count;
+#endif
+}
+
+// Whether anything was drawn that the current walk does not flip
+bool BROSE9323::_drawnSinceWalk(void) {
+	uint8_t drawn = 0;
+	for (uint8_t i = 0; i < _buffer_width; i++) {
+		drawn |= _dirty[i];
+	}
+#ifdef BROSE9323_CHANGE_LOG
+	drawn |= _log_count - _log_walk;
+#endif
+	return drawn;
+}
+
+// Forgets the columns and log entries the walk has flipped
+void BROSE9323::_finishWalk(void) {
+	memset(_walk_dirty, 0, _buffer_width);
+#ifdef BROSE9323_CHANGE_LOG
+	_log_count -= _log_walk;
+	memmove(_log, _log + _log_walk, _log_count * sizeof(_log[0]));
+	_log_walk = 0;
+#endif
+}
+
+#ifdef BROSE9323_CHANGE_LOG
+// A full log spills the entries no walk has started on into their columns
+void BROSE9323::_logChange(uint8_t x, uint8_t y) {
+#ifdef BROSE9323_ASYNC
+	noInterrupts();
+#endif
+	if (_log_count == BROSE9323_CHANGE_LOG) {
+		for (; _log_count > _log_walk; _log_count--) {
+			const uint8_t spilled = _log[_log_count - 1] & 0xFF;
+			_dirty[spilled / 8] |= 1 << (spilled & 7);
 		}
-		_new_buffer[y * _buffer_width + x / 8] &= ~(1 << (x & 7));
 	}
-	if (_direct_mode) {
-		_selectPanel(x / _panel_width);
-	
-		_selectColumn(x % _panel_width);
-	
-		_selectRow(y);
-	
-		_setData(_new_buffer[y * _buffer_width + x / 8] & (1 << (x & 7)));
-	
-		_strobe();
+	if (_log_count < BROSE9323_CHANGE_LOG) {
+		_log[_log_count++] = (uint16_t)y << 8 | x;
+	} else {
+		_dirty[x / 8] |= 1 << (x & 7);
+	}
+#ifdef BROSE9323_ASYNC
+	interrupts();
+#endif
+}
+#endif
+
+void BROSE9323::_resetCursor(FlipCursor& cursor, bool force) {
+	memset(&cursor, 0, sizeof(cursor));
+	cursor.rows_up = true;
+	cursor.force = force;
+}
+
+// Counts one step of a walk with a step limit, true once the limit is
+// used up. The step that hits it is not taken, the walk resumes there.
+inline bool BROSE9323::_scanPause(FlipCursor& c) {
+#ifdef BROSE9323_ASYNC
+	if (!c.steps || --c.steps) return false;
+	c.paused = true;
+	return true;
+#else
+	(void)c;
+	return false;
+#endif
+}
+
+// Finds the next dot that differs between target and _old_buffer within
+// the columns in _walk_dirty (and _dirty for a cursor with drawn set),
+// walking panel by panel. In SCAN_GROUPED
+// order all dots that are set go first, then all dots that are reset, so
+// the data lines switch at most twice per panel. Columns run back and
+// forth between the two passes and rows alternate direction from column
+// to column, so consecutive strobes share as many address bits as
+// possible. The plan is never stored, the cursor remembers where the
+// walk stopped.
+bool BROSE9323::_nextFlip(FlipCursor& c, const uint8_t* target, uint8_t& x, uint8_t& y, bool& b) {
+	const uint8_t passes = _scan_order == SCAN_GROUPED ? 2 : 1;
+	const uint8_t tiles = _tileCount();
+	for (; c.tile < tiles; c.tile++, c.pass = 0) {
+		uint8_t x0, panel_width, y0, panel_height;
+		_tileBounds(c.tile, x0, panel_width, y0, panel_height);
+		for (; c.pass < passes; c.pass++, c.n = 0) {
+			for (; c.n < panel_width; c.n++, c.k = 0) {
+				if (_scanPause(c)) return false;
+				x = (c.pass & 1) ? x0 + panel_width - 1 - c.n : x0 + c.n;
+				const uint8_t i = x / 8;
+				const uint8_t mask = 1 << (x & 7);
+				if (!c.force && !((_walk_dirty[i] | (c.drawn ? _dirty[i] : 0)) & mask)) continue;
+
+#ifdef BROSE9323_COLUMN_MAJOR
+				// The rows of the column that change in one go, minus those the
+				// cursor has passed, then the nearest one in walk direction
+				const uint16_t want = _columnBits(target, x);
+				uint16_t rows = (uint16_t)((1UL << (y0 + panel_height)) - (1UL << y0));
+				if (c.k == 0) BROSE9323_COUNT(dots_diffed, panel_height);
 #if !defined(__AVR_ATmega168P__) && !defined(__AVR_ATmega168PB__) && !defined(__AVR_ATmega168__)
-		if (color) {
-			if (_new_buffer[y * _buffer_width + x / 8] & (1 << (x & 7))) {
-				return;
-			}
-			_new_buffer[y * _buffer_width + x / 8] |= 1 << (x & 7);
-		} else {
-			if (~_new_buffer[y * _buffer_width + x / 8] & (1 << (x & 7))) {
-				return;
+				if (!c.force) rows &= want ^ _columnBits(_old_buffer, x);
+#endif
+				if (passes == 2) rows &= c.pass ? ~want : want;
+				if (c.rows_up) {
+					rows &= (uint16_t)(0xFFFFUL << (y0 + c.k));
+				} else {
+					rows &= (uint16_t)((1UL << (y0 + panel_height - c.k)) - 1);
+				}
+				if (rows) {
+					if (c.rows_up) {
+						y = __builtin_ctz(rows);
+						c.k = y - y0 + 1;
+					} else {
+						y = 8 * sizeof(unsigned int) - 1 - __builtin_clz(rows);
+						c.k = y0 + panel_height - y;
+					}
+					b = want & (1 << y);
+					c.column_hit = true;
+					return true;
+				}
+#else
+				for (; c.k < panel_height; c.k++) {
+					if (_scanPause(c)) return false;
+					BROSE9323_COUNT(dots_diffed, 1);
+					y = y0 + (c.rows_up ? c.k : panel_height - 1 - c.k);
+					b = target[y * _buffer_width + i] & mask;
+#if !defined(__AVR_ATmega168P__) && !defined(__AVR_ATmega168PB__) && !defined(__AVR_ATmega168__)
+					if (!c.force && (bool)(_old_buffer[y * _buffer_width + i] & mask) == b) {
+						continue;
+					}
+#endif
+					if (passes == 2 && b == (bool)c.pass) continue;
+
+					c.k++;
+					c.column_hit = true;
+					return true;
+				}
+#endif
+				if (c.column_hit && passes == 2) c.rows_up = !c.rows_up;
+				c.column_hit = false;
 			}
-			_new_buffer[y * _buffer_width + x / 8] &= ~(1 << (x & 7));
 		}
+	}
+#ifdef BROSE9323_CHANGE_LOG
+	// Then the logged dots whose column was not walked as a whole
+	const uint8_t log_end = c.drawn ? _log_count : _log_walk;
+	while (!c.force && c.log < log_end) {
+		if (_scanPause(c)) return false;
+		const uint16_t entry = _log[c.log++];
+		BROSE9323_COUNT(dots_diffed, 1);
+		x = entry & 0xFF;
+		y = entry >> 8;
+		const uint8_t i = x / 8;
+		const uint8_t mask = 1 << (x & 7);
+		if ((_walk_dirty[i] | (c.drawn ? _dirty[i] : 0)) & mask) continue;
+		b = _dot(target, x, y);
+		return true;
+	}
 #endif
+	return false;
+}
+
+void BROSE9323::_selectDot(uint8_t x, uint8_t y, bool b) {
+	uint8_t panel, col, row;
+	_dotAddress(x, y, panel, col, row);
+	_selectPanel(panel);
+	_selectColumn(col);
+	_selectRow(row);
+	_setData(b);
+}
+
+// ADDR, COL and ROW lines of a dot. The entries name the panel by its
+// grid cell, a layout turns that into the panel's address and mounting.
+void BROSE9323::_dotAddress(uint8_t x, uint8_t y, uint8_t& panel, uint8_t& col, uint8_t& row) {
+	col = _columnEntry(x, false);
+	row = _rowEntry(y, false);
+	if (_layout) {
+		panel = _layout->panels[(row >> 5) * _layout->columns + (col >> 5)];
+		if (panel & MIRROR_X << 3) col = _columnEntry(x, true);
+		if (panel & MIRROR_Y << 3) row = _rowEntry(y, true);
+	} else {
+		panel = col >> 5;
 	}
+	panel &= 0x07;
+	col &= 0x1F;
+	row &= 0x1F;
+}
+
+// Panels in walk order: the row of panels, or the layout's grid row by row
+uint8_t BROSE9323::_tileCount(void) {
+	if (_layout) return _layout->columns * _layout->rows;
+	return (width() + _panel_width - 1) / _panel_width;
+}
+
+void BROSE9323::_tileBounds(uint8_t tile, uint8_t& x0, uint8_t& w, uint8_t& y0, uint8_t& h) {
+	if (!_layout) {
+		x0 = tile * _panel_width;
+		w = min(_panel_width, width() - x0);
+		y0 = 0;
+		h = height();
+		return;
+	}
+	const uint8_t column = tile % _layout->columns;
+	const uint8_t row = tile / _layout->columns;
+	x0 = layoutSize(_layout->widths, column);
+	w = _layout->widths[column];
+	y0 = layoutSize(_layout->heights, row);
+	h = _layout->heights[row];
+}
+
+// The dot is on the panel now, keep the old buffer in sync
+void BROSE9323::_commitDot(uint8_t x, uint8_t y, bool b) {
+#if !defined(__AVR_ATmega168P__) && !defined(__AVR_ATmega168PB__) && !defined(__AVR_ATmega168__)
+	_setDot(_old_buffer, x, y, b);
 #endif
 }
+#endif
 
-void BROSE9323::fillScreen(uint16_t color) {
+void BROSE9323::drawPixel(int16_t x, int16_t y, uint16_t color) {
+	if (y >= height() || y < 0 || x >= width() || x < 0) return;
+	if (_dot(_new_buffer, x, y) == (bool)color) {
+		BROSE9323_COUNT(noop_pixels, 1);
+		return;
+	}
+	_setDot(_new_buffer, x, y, color);
 #ifdef ESP8266
-	stream->print(color ? "F1\n" : "F0\n");
+	if (_direct_mode) display();
 #else
-	memset(_new_buffer, color ? 0xFF : 0x00, _buffer_size);
 	if (_direct_mode) {
-		_setData(color);
+#ifdef BROSE9323_ASYNC
+		// A walk held back by the flip limit must not undo this dot later
+		waitIdle();
+		_setDot(_target_buffer, x, y, color);
+#endif
+		_selectDot(x, y, color);
+
+		_strobe();
+
+		_commitDot(x, y, color);
+	} else {
+		_markChanged(x, y);
+	}
+#endif
+}
+
+void BROSE9323::fillScreen(uint16_t color) {
+	memset(_new_buffer, color ? 0xFF : 0x00, _buffer_size);
+#ifdef ESP8266
+	if (_direct_mode) display();
+#else
+	if (_direct_mode && _flip_limit) {
+		// Flipped like a frame, the dots over the limit by later display()
+		markDirty(0, width());
+		display();
+	} else if (_direct_mode) {
+#ifdef BROSE9323_ASYNC
+		waitIdle();
+#endif
 		for (uint8_t x = 0; x < width(); x++) {
-			if (x % _panel_width == 0) {
-				_selectPanel(x / _panel_width);
-			}
-		
-			_selectColumn(x % _panel_width);
-		
 			for (uint8_t y = 0; y < height(); y++) {
-				_selectRow(y);
-			
+				_selectDot(x, y, color);
 				_strobe();
 			}
 		}
 #if !defined(__AVR_ATmega168P__) && !defined(__AVR_ATmega168PB__) && !defined(__AVR_ATmega168__)
 		memset(_old_buffer, color ? 0xFF : 0x00, _buffer_size);
 #endif
+	} else {
+		markDirty(0, width());
 	}
 #endif
 }
 
-void BROSE9323::setTiming(uint16_t t) {
+// The direct mode strobes every dot, there the GFX defaults draw pixel by
+// pixel through drawPixel()
+void BROSE9323::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+	if (_direct_mode) {
+		Adafruit_GFX::drawFastHLine(x, y, w, color);
+		return;
+	}
+	fillRect(x, y, w, 1, color);
+}
+
+void BROSE9323::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+	if (_direct_mode) {
+		Adafruit_GFX::drawFastVLine(x, y, h, color);
+		return;
+	}
+	fillRect(x, y, 1, h, color);
+}
+
+void BROSE9323::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+	if (_direct_mode) {
+		Adafruit_GFX::fillRect(x, y, w, h, color);
+		return;
+	}
+	if (x < 0) {
+		w += x;
+		x = 0;
+	}
+	if (y < 0) {
+		h += y;
+		y = 0;
+	}
+	if (x + w > width()) w = width() - x;
+	if (y + h > height()) h = height() - y;
+	if (w <= 0 || h <= 0) return;
+
+#ifdef BROSE9323_COLUMN_MAJOR
+	// The rows of each column at once
+	const uint16_t rows = (uint16_t)((1UL << (y + h)) - (1UL << y));
+	for (int16_t i = x; i < x + w; i++) {
+		const uint16_t bits = _columnBits(_new_buffer, i);
+		_setColumnBits(_new_buffer, i, color ? bits | rows : bits & ~rows);
+	}
+#else
+	// Partial bytes at both ends of a row, whole bytes in between
+	const uint8_t first = x / 8;
+	const uint8_t last = (x + w - 1) / 8;
+	uint8_t first_mask = 0xFF << (x & 7);
+	const uint8_t last_mask = 0xFF >> (7 - ((x + w - 1) & 7));
+	if (first == last) first_mask &= last_mask;
+
+	uint8_t* row = _new_buffer + y * _buffer_width;
+	for (; h > 0; h--, row += _buffer_width) {
+		if (color) {
+			row[first] |= first_mask;
+		} else {
+			row[first] &= ~first_mask;
+		}
+		if (first == last) continue;
+		memset(row + first + 1, color ? 0xFF : 0x00, last - first - 1);
+		if (color) {
+			row[last] |= last_mask;
+		} else {
+			row[last] &= ~last_mask;
+		}
+	}
+#endif
+	markDirty(x, w);
+}
+
+void BROSE9323::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) {
+	_drawBitmap(x, y, bitmap, w, h, color, 0, BITMAP_PROGMEM);
+}
+
+void BROSE9323::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg) {
+	_drawBitmap(x, y, bitmap, w, h, color, bg, BITMAP_PROGMEM | BITMAP_BG);
+}
+
+void BROSE9323::drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color) {
+	_drawBitmap(x, y, bitmap, w, h, color, 0, 0);
+}
+
+void BROSE9323::drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg) {
+	_drawBitmap(x, y, bitmap, w, h, color, bg, BITMAP_BG);
+}
+
+// GFX bitmaps have their leftmost pixel in bit 7, the buffer in bit 0
+static uint8_t _reverseBits(uint8_t b) {
+	b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+	b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+	b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
+	return b;
+}
+
+void BROSE9323::_drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg, uint8_t mode) {
+	if (_direct_mode) {
+		switch (mode) {
+			case BITMAP_PROGMEM:
+				Adafruit_GFX::drawBitmap(x, y, bitmap, w, h, color);
+				break;
+			case BITMAP_PROGMEM | BITMAP_BG:
+				Adafruit_GFX::drawBitmap(x, y, bitmap, w, h, color, bg);
+				break;
+			case 0:
+				Adafruit_GFX::drawBitmap(x, y, (uint8_t*)bitmap, w, h, color);
+				break;
+			default:
+				Adafruit_GFX::drawBitmap(x, y, (uint8_t*)bitmap, w, h, color, bg);
+				break;
+		}
+		return;
+	}
+
+	const int16_t bitmap_width = (w + 7) / 8;
+	for (int16_t j = y < 0 ? -y : 0; j < h && y + j < height(); j++) {
+		for (int16_t i = 0; i < bitmap_width; i++) {
+			const int16_t cx = x + i * 8;
+			if (cx <= -8) continue;
+			if (cx >= width()) break;
+
+			const uint8_t* src = bitmap + j * bitmap_width + i;
+			const uint8_t area = w - i * 8 >= 8 ? 0xFF : 0xFF >> (8 - (w - i * 8));
+			const uint8_t ink = _reverseBits(mode & BITMAP_PROGMEM ? pgm_read_byte(src) : *src) & area;
+			uint8_t bits = color ? ink : 0;
+			if (mode & BITMAP_BG) {
+				if (bg) bits |= area & ~ink;
+				_writeBits(y + j, cx, bits, area);
+			} else {
+				_writeBits(y + j, cx, bits, ink);
+			}
+		}
+	}
+	markDirty(x, w);
+}
+
+// Writes the masked bits of 8 pixels starting at column x of row y, the
+// part outside the screen is dropped
+void BROSE9323::_writeBits(int16_t y, int16_t x, uint8_t bits, uint8_t mask) {
+	if (x < 0) {
+		bits >>= -x;
+		mask >>= -x;
+		x = 0;
+	}
+	if (width() - x < 8) mask &= 0xFF >> (8 - (width() - x));
+	bits &= mask;
+
+#ifdef BROSE9323_COLUMN_MAJOR
+	for (uint8_t b = 0; mask; b++, mask >>= 1, bits >>= 1) {
+		if (mask & 1) _setDot(_new_buffer, x + b, y, bits & 1);
+	}
+#else
+	const uint8_t shift = x & 7;
+	uint8_t* p = _new_buffer + y * _buffer_width + x / 8;
+	p[0] = (p[0] & ~(mask << shift)) | bits << shift;
+	if (shift && (mask >> (8 - shift))) {
+		p[1] = (p[1] & ~(mask >> (8 - shift))) | bits >> (8 - shift);
+	}
+#endif
+}
+
+void BROSE9323::scroll(int16_t dx, int16_t dy, uint16_t fill) {
+	_shiftRect(0, 0, width(), height(), dx, dy, false, fill);
+}
+
+void BROSE9323::roll(int16_t dx, int16_t dy) {
+	_shiftRect(0, 0, width(), height(), dx, dy, true, 0);
+}
+
+void BROSE9323::scrollRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy, uint16_t fill) {
+	_shiftRect(x, y, w, h, dx, dy, false, fill);
+}
+
+void BROSE9323::rollRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy) {
+	_shiftRect(x, y, w, h, dx, dy, true, 0);
+}
+
+#ifndef BROSE9323_COLUMN_MAJOR
+// Mask of the columns [x0, x1] within byte i of a row
+static uint8_t _spanMask(uint8_t i, uint8_t x0, uint8_t x1) {
+	uint8_t mask = 0xFF;
+	if (i == x0 / 8) mask &= 0xFF << (x0 & 7);
+	if (i == x1 / 8) mask &= 0xFF >> (7 - (x1 & 7));
+	return mask;
+}
+
+// Reverses the order of rows [lo, hi], only columns [x0, x1] move
+static void _reverseRows(uint8_t* top, uint8_t buffer_width, int16_t lo, int16_t hi, uint8_t x0, uint8_t x1) {
+	for (; lo < hi; lo++, hi--) {
+		uint8_t* a = top + lo * buffer_width;
+		uint8_t* b = top + hi * buffer_width;
+		for (uint8_t i = x0 / 8; i <= x1 / 8; i++) {
+			const uint8_t t = (a[i] ^ b[i]) & _spanMask(i, x0, x1);
+			a[i] ^= t;
+			b[i] ^= t;
+		}
+	}
+}
+#else
+// Reverses the order of columns [lo, hi], only the given rows move
+void BROSE9323::_reverseColumns(uint8_t* buffer, int16_t lo, int16_t hi, uint16_t rows) {
+	for (; lo < hi; lo++, hi--) {
+		const uint16_t t = (_columnBits(buffer, lo) ^ _columnBits(buffer, hi)) & rows;
+		_setColumnBits(buffer, lo, _columnBits(buffer, lo) ^ t);
+		_setColumnBits(buffer, hi, _columnBits(buffer, hi) ^ t);
+	}
+}
+#endif
+
+void BROSE9323::_shiftRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy, bool roll, uint16_t fill) {
+	if (x < 0) {
+		w += x;
+		x = 0;
+	}
+	if (y < 0) {
+		h += y;
+		y = 0;
+	}
+	if (x + w > width()) w = width() - x;
+	if (y + h > height()) h = height() - y;
+	if (w <= 0 || h <= 0) return;
+
+	const uint8_t x1 = x + w - 1;
+#ifdef BROSE9323_COLUMN_MAJOR
+	// A column is one word: rows move by shifting it, columns by moving
+	// words around
+	const uint16_t rows = (uint16_t)((1UL << (y + h)) - (1UL << y));
+	if (roll) {
+		dy %= h;
+		if (dy < 0) dy += h;
+	} else if (dy > h) {
+		// Moved out of the rectangle altogether, and shifts of 32 bits or
+		// more are undefined
+		dy = h;
+	} else if (dy < -h) {
+		dy = -h;
+	}
+	if (dy) {
+		const uint16_t uncovered = rows & ~(dy > 0 ? (uint32_t)rows << dy : rows >> -dy);
+		for (uint8_t i = x; i <= x1; i++) {
+			const uint32_t bits = _columnBits(_new_buffer, i) & rows;
+			uint32_t moved;
+			if (roll) {
+				moved = bits << dy | bits >> (h - dy);
+			} else {
+				moved = dy > 0 ? bits << dy : bits >> -dy;
+				if (fill) moved |= uncovered;
+			}
+			_setColumnBits(_new_buffer, i, (_columnBits(_new_buffer, i) & ~rows) | (moved & rows));
+		}
+	}
+
+	if (roll) {
+		dx %= w;
+		if (dx < 0) dx += w;
+		if (dx) {
+			// Rotated right by three reversals
+			_reverseColumns(_new_buffer, x, x1, rows);
+			_reverseColumns(_new_buffer, x, x + dx - 1, rows);
+			_reverseColumns(_new_buffer, x + dx, x1, rows);
+		}
+	} else if (dx) {
+		// Copied in the direction that reads each column before it is
+		// overwritten
+		for (int16_t i = dx > 0 ? x1 : x; i >= x && i <= x1; i += dx > 0 ? -1 : 1) {
+			const int16_t src = i - dx;
+			const uint16_t bits = src >= x && src <= x1 ? _columnBits(_new_buffer, src) : fill ? 0xFFFF : 0x0000;
+			_setColumnBits(_new_buffer, i, (_columnBits(_new_buffer, i) & ~rows) | (bits & rows));
+		}
+	}
+#else
+	uint8_t* top = _new_buffer + y * _buffer_width;
+
+	// Rows: roll rotates them by three reversals, scroll copies them over
+	if (roll) {
+		dy %= h;
+		if (dy < 0) dy += h;
+		if (dy) {
+			_reverseRows(top, _buffer_width, 0, h - 1, x, x1);
+			_reverseRows(top, _buffer_width, 0, dy - 1, x, x1);
+			_reverseRows(top, _buffer_width, dy, h - 1, x, x1);
+		}
+	} else if (dy) {
+		for (int16_t j = dy > 0 ? h - 1 : 0; j >= 0 && j < h; j += dy > 0 ? -1 : 1) {
+			uint8_t* row = top + j * _buffer_width;
+			const int16_t src = j - dy;
+			const uint8_t* from = src >= 0 && src < h ? top + src * _buffer_width : NULL;
+			for (uint8_t i = x / 8; i <= x1 / 8; i++) {
+				const uint8_t mask = _spanMask(i, x, x1);
+				const uint8_t bits = from ? from[i] : fill ? 0xFF : 0x00;
+				row[i] = (row[i] & ~mask) | (bits & mask);
+			}
+		}
+	}
+
+	// Columns: 8 at a time from a copy of the row, bit by bit only where
+	// the source crosses the edge of the rectangle
+	if (roll) {
+		dx %= w;
+		if (dx < 0) dx += w;
+	}
+	if (dx) {
+		uint8_t line[33];
+		line[_buffer_width] = 0;
+		for (int16_t j = 0; j < h; j++) {
+			uint8_t* row = top + j * _buffer_width;
+			memcpy(line, row, _buffer_width);
+			for (int16_t cx = x; cx <= x1; cx += 8) {
+				const int16_t sx = cx - dx;
+				uint8_t bits = 0;
+				if (sx >= x && sx + 7 <= x1) {
+					bits = (line[sx / 8] | line[sx / 8 + 1] << 8) >> (sx & 7);
+				} else {
+					for (uint8_t b = 0; b < 8; b++) {
+						int16_t c = sx + b;
+						if (c < x || c > x1) {
+							if (!roll) {
+								if (fill) bits |= 1 << b;
+								continue;
+							}
+							c = x + ((c - x) % w + w) % w;
+						}
+						if (line[c / 8] & (1 << (c & 7))) bits |= 1 << b;
+					}
+				}
+				_writeBits(y + j, cx, bits, x1 - cx >= 7 ? 0xFF : 0xFF >> (7 - (x1 - cx)));
+			}
+		}
+	}
+#endif
+
+	if (_direct_mode) {
 #ifdef ESP8266
-	stream->write('T');
-	stream->print(t);
-	stream->write('\n');
+		display();
 #else
+		// Only the dots that changed are strobed: what dot i, j showed
+		// before is at i + dx, j + dy now (wrapped around by roll, which
+		// has brought dx and dy into the rectangle). Where the shift moved
+		// it out of the rectangle the dot is strobed all the same.
+		for (int16_t j = y; j < y + h; j++) {
+			for (int16_t i = x; i <= x1; i++) {
+				const bool color = _dot(_new_buffer, i, j);
+				int32_t si = (int32_t)i + dx;
+				int32_t sj = (int32_t)j + dy;
+				if (roll) {
+					if (si > x1) si -= w;
+					if (sj >= y + h) sj -= h;
+				}
+				if (si >= x && si <= x1 && sj >= y && sj < y + h && _dot(_new_buffer, si, sj) == color) continue;
+				_setDot(_new_buffer, i, j, !color);
+				drawPixel(i, j, color);
+			}
+		}
+#endif
+	} else {
+		markDirty(x, w);
+	}
+}
+
+void BROSE9323::markDirty(int16_t x, int16_t w) {
+#ifndef ESP8266
+	if (x < 0) {
+		w += x;
+		x = 0;
+	}
+	if (x + w > width()) w = width() - x;
+	for (; w > 0; x++, w--) {
+		_dirty[x / 8] |= 1 << (x & 7);
+	}
+#endif
+	// The ESP8266 build compares whole frames in display()
+}
+
+void BROSE9323::setTiming(uint16_t t) {
 	_flip_time = t;
+#ifdef ESP8266
+	// Understood by the controller between frame streams
+	stream->print("!timing ");
+	stream->println(t);
 #endif
 }
 
+uint16_t BROSE9323::getTiming(void) {
+	return _flip_time;
+}
+
 void BROSE9323::setDirect(bool d) {
 	_direct_mode = d;
 }
@@ -195,48 +1119,83 @@ void BROSE9323::setDirect(bool d) {
 void BROSE9323::printBuffer(void) {
 	for (uint8_t y = 0; y < height(); y++) {
 		for (uint8_t x = 0; x < width(); x++) {
-			Serial.write(_new_buffer[y * _buffer_width + x / 8] & (1 << (x & 7)) ? '*' : ' ');
+			Serial.write(_dot(_new_buffer, x, y) ? '*' : ' ');
 		}
 		Serial.println();
 	}
 }
 
+// Only a layout has mirrored entries, its table holds them behind the
+// ones as wired
+uint8_t BROSE9323::_columnEntry(uint8_t x, bool mirrored) {
+	if (_column_table) return pgm_read_byte(_column_table + (mirrored ? width() : 0) + x);
+	return columnEntry(x, width(), _panel_width, 0);
+}
+
+uint8_t BROSE9323::_rowEntry(uint8_t y, bool mirrored) {
+	if (_row_table) return pgm_read_byte(_row_table + (mirrored ? height() : 0) + y);
+	return rowEntry(y, height(), 0);
+}
+
 void BROSE9323::_selectColumn(uint8_t col) {
-	col = width()-col-1;
 	if (_active_col == col) return;
 	_active_col = col;
-	col += 1 + col / 7;
+	BROSE9323_COUNT(pin_writes, 5);
+#ifdef BROSE9323_PORT_IO
+	broseWritePins(col, COL_0, COL_1, COL_2, COL_3, COL_4);
+#else
 	digitalWrite(COL_0, col &  1);
 	digitalWrite(COL_1, col &  2);
 	digitalWrite(COL_2, col &  4);
 	digitalWrite(COL_3, col &  8);
 	digitalWrite(COL_4, col & 16);
+#endif
 }
 
 void BROSE9323::_selectPanel(uint8_t panel) {
 	if (_active_panel == panel) return;
 	_active_panel = panel;
+	BROSE9323_COUNT(pin_writes, 3);
+#ifdef BROSE9323_PORT_IO
+	broseWritePins(panel, ADDR_0, ADDR_1, ADDR_2);
+#else
 	digitalWrite(ADDR_0, panel & 1);
 	digitalWrite(ADDR_1, panel & 2);
 	digitalWrite(ADDR_2, panel & 4);
+#endif
 }
 
 void BROSE9323::_selectRow(uint8_t row) {
-	row = height()-row-1;
-	row = row + 3;
 	if (_active_row == row) return;
 	_active_row = row;
-	row += row / 7;
+	BROSE9323_COUNT(pin_writes, 5);
+#ifdef BROSE9323_PORT_IO
+	broseWritePins(row, ROW_0, ROW_1, ROW_2, ROW_3, ROW_4);
+#else
 	digitalWrite(ROW_0, row &  1);
 	digitalWrite(ROW_1, row &  2);
 	digitalWrite(ROW_2, row &  4);
 	digitalWrite(ROW_3, row &  8);
 	digitalWrite(ROW_4, row & 16);
+#endif
 }
 
 void BROSE9323::_setData(bool data) {
 	if (_active_data == data) return;
 	_active_data = data;
+	BROSE9323_COUNT(pin_writes, 3);
+	// Always release one row driver before enabling the other one
+#ifdef BROSE9323_PORT_IO
+	if (data) {
+		broseWritePin(ROW_RESET, 1);
+		broseWritePin(ROW_SET,   0);
+		broseWritePin(COL_DATA,  0);
+	} else {
+		broseWritePin(ROW_SET,   1);
+		broseWritePin(ROW_RESET, 0);
+		broseWritePin(COL_DATA,  1);
+	}
+#else
 	if (data) {
 		digitalWrite(ROW_RESET, 1);
 		digitalWrite(ROW_SET,   0);
@@ -246,15 +1205,26 @@ void BROSE9323::_setData(bool data) {
 		digitalWrite(ROW_RESET, 0);
 		digitalWrite(COL_DATA,  1);
 	}
+#endif
+}
+
+void BROSE9323::_setEnable(bool enable) {
+	BROSE9323_COUNT(pin_writes, 1);
+#ifdef BROSE9323_PORT_IO
+	broseWritePin(ENABLE, enable);
+#else
+	digitalWrite(ENABLE, enable);
+#endif
 }
 
 void BROSE9323::_strobe(void) {
-	digitalWrite(ENABLE, 0);
+	BROSE9323_COUNT(strobes, 1);
+	_setEnable(0);
 	delayMicroseconds(_flip_time);
-	digitalWrite(ENABLE, 1);
+	_setEnable(1);
 	delayMicroseconds(_flip_time*2);
-	digitalWrite(ENABLE, 0);
+	_setEnable(0);
 	delayMicroseconds(_flip_time);
-	digitalWrite(ENABLE, 1);
+	_setEnable(1);
 }
 #endif
@@ -2,9 +2,82 @@
 #define BROSE9323_H
 
 #include <Adafruit_GFX.h>
+#include "BROSE9323_io.h"
 
 //#define FLIPDOT_PLCC_ADAPTER
 
+#ifdef ESP8266
+#include "FrameProtocol.h"
+
+// How long display() waits for the controller to flip the previous frame
+#ifndef BROSE9323_ACK_TIMEOUT
+#define BROSE9323_ACK_TIMEOUT 5000
+#endif
+#endif
+
+// Frame sized buffers: _new_buffer, _old_buffer except on the ATmega168,
+// and the flip engine's target
+#if defined(__AVR_ATmega168P__) || defined(__AVR_ATmega168PB__) || defined(__AVR_ATmega168__)
+#define BROSE9323_OLD_FRAMES 0
+#else
+#define BROSE9323_OLD_FRAMES 1
+#endif
+#ifdef BROSE9323_ASYNC
+#define BROSE9323_FRAMES (BROSE9323_OLD_FRAMES + 2)
+#else
+#define BROSE9323_FRAMES (BROSE9323_OLD_FRAMES + 1)
+#endif
+
+// Without _old_buffer a changed column means strobing all of its dots, so
+// single dots are kept in a log of this many entries (2 bytes each)
+#if BROSE9323_OLD_FRAMES == 0 && !defined(BROSE9323_CHANGE_LOG)
+#define BROSE9323_CHANGE_LOG 32
+#endif
+
+// The flip engine looks at no more than this many columns and dots per
+// timer interrupt, interrupts are off meanwhile. A walk that gets that far
+// without a dot to flip goes on BROSE9323_SCAN_PAUSE microseconds later,
+// which leaves room for the serial and the other interrupts.
+#ifdef BROSE9323_ASYNC
+#ifndef BROSE9323_SCAN_STEPS
+#define BROSE9323_SCAN_STEPS 64
+#endif
+#ifndef BROSE9323_SCAN_PAUSE
+#define BROSE9323_SCAN_PAUSE 20
+#endif
+#endif
+
+// Define BROSE9323_COUNTERS to have the driver count what it does, see
+// BROSE9323::counters(). Without it the counting compiles to nothing.
+#ifdef BROSE9323_COUNTERS
+#define BROSE9323_COUNT(counter, n) (_counters.counter += (n))
+#else
+#define BROSE9323_COUNT(counter, n) ((void)0)
+#endif
+
+// Define BROSE9323_COLUMN_MAJOR to store a frame column by column, one 16
+// bit word per column with bit y for row y, in the order display() walks
+// it. A column is then compared with a single XOR. Needs a height of at
+// most 16. Without it a frame is stored row by row, (w + 7) / 8 bytes per
+// row with bit 0 for the leftmost dot, which is also the layout of the
+// frame protocol.
+#ifdef BROSE9323_COLUMN_MAJOR
+#ifdef ESP8266
+#error "BROSE9323_COLUMN_MAJOR is for the controller, the ESP8266 sends row-major frames"
+#endif
+#define BROSE9323_BUFFER_SIZE(w, h) (2 * (w))
+#else
+#define BROSE9323_BUFFER_SIZE(w, h) ((((w) + 7) / 8) * (h))
+#endif
+
+// Bytes of buffers a display of w x h dots needs, the frames plus either
+// the two column masks or the ESP8266's message buffer
+#ifdef ESP8266
+#define BROSE9323_STORAGE_SIZE(w, h) (BROSE9323_FRAMES * BROSE9323_BUFFER_SIZE(w, h) + FRAME_COLUMNS_MAX(w, h) + FRAME_OVERHEAD)
+#else
+#define BROSE9323_STORAGE_SIZE(w, h) (BROSE9323_FRAMES * BROSE9323_BUFFER_SIZE(w, h) + 2 * (((w) + 7) / 8))
+#endif
+
 const uint8_t _hannio_splash[] PROGMEM = {
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x39, 0xff, 0xff, 0xff, 0xff, 0xfe, 0x70, 
 	0x3e, 0x00, 0x39, 0xff, 0xff, 0xff, 0xff, 0xfe, 0x70, 0xff, 0x00, 0x39, 0xff, 0xff, 0xff, 0xff, 
@@ -18,23 +91,247 @@ const uint8_t _hannio_splash[] PROGMEM = {
 };
 
 class BROSE9323 : public Adafruit_GFX {
+	public:
+		// Order in which display() strobes the changed dots
+		enum ScanOrder : uint8_t {
+			SCAN_COLUMNS, // column by column, rows top to bottom
+			SCAN_GROUPED  // per panel: all sets, then all resets
+		};
+
+		struct FlipPlanStats {
+			uint16_t strobes;     // dots that would be flipped
+			uint16_t transitions; // ADDR, COL, ROW and data line changes between them
+		};
+
+#ifdef BROSE9323_COUNTERS
+		// Totals since the last resetCounters()
+		struct Counters {
+			uint32_t strobes;
+			uint32_t pin_writes;   // ADDR, COL, ROW, data and ENABLE lines set
+			uint32_t noop_pixels;  // drawPixel() with the dot already in that color
+			uint32_t displays;     // display() calls
+			uint32_t dots_diffed;  // dots the flip walks compared, planFlips() included
+			uint32_t display_us_min;
+			uint32_t display_us_max;
+			uint32_t display_us_sum; // average is display_us_sum / displays
+		};
+#endif
+
+		// Orientation flags of BROSE9323Fixed, applied to the coil addresses
+		enum Orientation : uint8_t {
+			MIRROR_X   = 1,
+			MIRROR_Y   = 2,
+			ROTATE_180 = MIRROR_X | MIRROR_Y
+		};
+
+	private:
+		// Column and row addresses skip every 8th line of the 5 bit address bus
+		static constexpr uint8_t _addressLine(uint8_t n, uint8_t skip) {
+			return (n + skip + n / 7) & 0x1F;
+		}
+
+		// Which of count panels of the given sizes dot n falls into, and
+		// where within it
+		static constexpr uint8_t _tileOf(const uint8_t* sizes, uint8_t count, uint8_t n, uint8_t i = 0) {
+			return i + 1 >= count || n < sizes[i] ? i : _tileOf(sizes, count, n - sizes[i], i + 1);
+		}
+		static constexpr uint8_t _tileOffset(const uint8_t* sizes, uint8_t count, uint8_t n, uint8_t i = 0) {
+			return i + 1 >= count || n < sizes[i] ? n : _tileOffset(sizes, count, n - sizes[i], i + 1);
+		}
+		static constexpr uint8_t _layoutColumn(uint8_t w, uint8_t n, bool mirrored) {
+			return _addressLine(mirrored ? n : w - 1 - n, 1);
+		}
+		static constexpr uint8_t _layoutRow(uint8_t h, uint8_t n, bool mirrored) {
+			return _addressLine(mirrored ? n + 3 : h - 1 - n + 3, 0);
+		}
+
+	public:
+		// Coil address of column x: panel in bits 5-7, column in bits 0-4
+		static constexpr uint8_t columnEntry(uint8_t x, uint8_t w, uint8_t pw, uint8_t flags) {
+			return flags & MIRROR_X ? columnEntry(w - 1 - x, w, pw, 0) :
+				(x / pw) << 5 | _addressLine(w - 1 - x % pw, 1);
+		}
+
+		// Coil address of row y
+		static constexpr uint8_t rowEntry(uint8_t y, uint8_t h, uint8_t flags) {
+			return flags & MIRROR_Y ? rowEntry(h - 1 - y, h, 0) : _addressLine(h - 1 - y + 3, 0);
+		}
+
+		// Panels in a grid of up to 8, for walls that are more than one panel
+		// high or have panels mounted the other way round. Panel column c is
+		// widths[c] dots wide, panel row r is heights[r] dots high. panels[]
+		// holds one panel() per grid cell, row by row from the top left.
+		struct Layout {
+			uint8_t columns;
+			uint8_t rows;
+			uint8_t widths[8];
+			uint8_t heights[8];
+			uint8_t panels[8];
+		};
+
+		// Grid cell of a Layout: the panel's ADDR value and Orientation flags
+		static constexpr uint8_t panel(uint8_t address, uint8_t flags = 0) {
+			return address | flags << 3;
+		}
+
+		// Sum and largest of the first count widths or heights of a layout
+		static constexpr uint16_t layoutSize(const uint8_t* sizes, uint8_t count) {
+			return count ? sizes[count - 1] + layoutSize(sizes, count - 1) : 0;
+		}
+		static constexpr uint8_t layoutMax(const uint8_t* sizes, uint8_t count) {
+			return count == 0 ? 0 : sizes[count - 1] > layoutMax(sizes, count - 1) ?
+				sizes[count - 1] : layoutMax(sizes, count - 1);
+		}
+
+		// Panel column in bits 5-7 and coil address of column x of a layout,
+		// as wired or for a panel mounted with MIRROR_X
+		static constexpr uint8_t layoutColumnEntry(const Layout& l, uint8_t x, bool mirrored) {
+			return _tileOf(l.widths, l.columns, x) << 5 |
+				_layoutColumn(l.widths[_tileOf(l.widths, l.columns, x)], _tileOffset(l.widths, l.columns, x), mirrored);
+		}
+
+		// Panel row in bits 5-7 and coil address of row y of a layout
+		static constexpr uint8_t layoutRowEntry(const Layout& l, uint8_t y, bool mirrored) {
+			return _tileOf(l.heights, l.rows, y) << 5 |
+				_layoutRow(l.heights[_tileOf(l.heights, l.rows, y)], _tileOffset(l.heights, l.rows, y), mirrored);
+		}
+
+	protected:
+		bool _direct_mode = false;
+
+		// Dot x, y of a frame buffer in the configured layout
+		bool _dot(const uint8_t* buffer, uint8_t x, uint8_t y) {
+#ifdef BROSE9323_COLUMN_MAJOR
+			return buffer[2 * x + (y >> 3)] & (1 << (y & 7));
+#else
+			return buffer[y * _buffer_width + (x >> 3)] & (1 << (x & 7));
+#endif
+		}
+		void _setDot(uint8_t* buffer, uint8_t x, uint8_t y, bool b) {
+#ifdef BROSE9323_COLUMN_MAJOR
+			uint8_t* p = buffer + 2 * x + (y >> 3);
+			const uint8_t mask = 1 << (y & 7);
+#else
+			uint8_t* p = buffer + y * _buffer_width + (x >> 3);
+			const uint8_t mask = 1 << (x & 7);
+#endif
+			if (b) {
+				*p |= mask;
+			} else {
+				*p &= ~mask;
+			}
+		}
+#ifdef BROSE9323_COLUMN_MAJOR
+		// All rows of column x of a frame buffer
+		static uint16_t _columnBits(const uint8_t* buffer, uint8_t x) {
+			return buffer[2 * x] | buffer[2 * x + 1] << 8;
+		}
+		static void _setColumnBits(uint8_t* buffer, uint8_t x, uint16_t bits) {
+			buffer[2 * x] = bits;
+			buffer[2 * x + 1] = bits >> 8;
+		}
+		static void _reverseColumns(uint8_t*, int16_t, int16_t, uint16_t);
+#endif
+#ifdef BROSE9323_COUNTERS
+		Counters _counters;
+
+		void _countDisplay(uint32_t start);
+#endif
+#ifndef ESP8266
+		uint8_t* _dirty = NULL;      // columns drawn to since the last display()
+		// PROGMEM tables of columnEntry() and rowEntry(), computed on the fly
+		// when NULL. With a _layout they hold layoutColumnEntry() and
+		// layoutRowEntry(), first as wired and then mirrored.
+		const uint8_t* _column_table = NULL;
+		const uint8_t* _row_table = NULL;
+		const Layout* _layout = NULL; // NULL: one row of _panel_width wide panels
+
+		// Marks a dot of _new_buffer that changed for the next display()
+		void _markChanged(uint8_t x, uint8_t y) {
+#ifdef BROSE9323_CHANGE_LOG
+			_logChange(x, y);
+#else
+			_dirty[x >> 3] |= 1 << (x & 7);
+#endif
+		}
+#endif
+
+		// Uses storage of BROSE9323_STORAGE_SIZE(w, h) bytes for the buffers
+		BROSE9323(uint8_t, uint8_t, uint8_t, uint16_t, uint8_t* storage);
+
 	private:
 		uint16_t _flip_time;
 		const uint8_t _panel_width;
 		const uint8_t _buffer_width;
 		const uint16_t _buffer_size;
-		bool _direct_mode = false;
 
 #ifdef ESP8266
 		Stream* stream;
+		uint8_t* _frame;            // COLUMNS message sent by display()
+		uint8_t _seq = 0;           // SEQ of the last message
+		bool _ack_pending = false;  // the last message is not acknowledged yet
+		bool _resync = true;        // the controller's buffer is unknown, send all columns
+
+		void _waitAck(void);
 #else
+		// Position of a walk through the flip plan
+		struct FlipCursor {
+			uint8_t tile;     // panel in walk order
+			uint8_t pass;     // 0: sets, 1: resets
+			uint8_t n;        // column within the panel pass
+			uint8_t k;        // row within the column
+			bool rows_up;
+			bool column_hit;
+			bool force;
+			bool drawn;       // also walk columns not merged into _walk_dirty yet
+#ifdef BROSE9323_ASYNC
+			uint8_t steps;    // columns and dots to look at before pausing, 0: no limit
+			bool paused;      // the walk stopped for steps, not at its end
+#endif
+#ifdef BROSE9323_CHANGE_LOG
+			uint8_t log;      // next change log entry
+#endif
+		};
+
+		uint8_t* _walk_dirty = NULL; // columns the flip plan walks
+		FlipCursor _cursor;
+		bool _walk_active = false;
+		uint16_t _flip_limit = 0;    // strobes per display(), 0: no limit
+		bool _converging = false;    // the panel lags behind the buffer
+		uint32_t _converge_start;    // micros() the panel fell behind
+		uint32_t _converge_us = 0;
+#ifdef BROSE9323_CHANGE_LOG
+		uint16_t _log[BROSE9323_CHANGE_LOG]; // changed dots, y << 8 | x
+		uint8_t _log_count = 0;
+		uint8_t _log_walk = 0;               // entries the current walk flips
+
+		void _logChange(uint8_t, uint8_t);
+#endif
+#ifdef BROSE9323_ASYNC
+		enum EngineState : uint8_t {
+			ENGINE_IDLE,
+			ENGINE_NEXT,
+			ENGINE_PULSE_1,
+			ENGINE_GAP,
+			ENGINE_PULSE_2
+		};
+
+		uint8_t* _target_buffer = NULL; // frame the engine flips towards
+		volatile EngineState _engine_state = ENGINE_IDLE;
+		uint8_t _engine_x;
+		uint8_t _engine_y;
+		bool _engine_data;
+		uint16_t _engine_budget;        // strobes left with a flip limit
+		void (*_frame_committed)(void) = NULL;
+#endif
 		uint8_t _active_panel = 255;
 		uint8_t _active_col = 255;
 		uint8_t _active_row = 255;
-		bool _active_data;
+		bool _active_data = false;
+		ScanOrder _scan_order = SCAN_GROUPED;
 
 #ifndef FLIPDOT_PLCC_ADAPTER
-		const uint8_t ENABLE    =  7,
+		static const uint8_t ENABLE    =  7,
 					  ADDR_0    =  3,
 					  ADDR_1    =  5,
 					  ADDR_2    =  6,
@@ -52,7 +349,7 @@ class BROSE9323 : public Adafruit_GFX {
 					  ROW_RESET = 13,
 					  ROW_SET   = A5;
 #else
-		const uint8_t RELAY     =  2,
+		static const uint8_t RELAY     =  2,
 					  ENABLE    =  3,
 					  ADDR_0    =  7,
 					  ADDR_1    =  6,
@@ -72,12 +369,42 @@ class BROSE9323 : public Adafruit_GFX {
 					  ROW_SET   = A5;
 #endif
 		
+#ifdef BROSE9323_PROFILE
+		// The profiling firmware (src/profile/profile.cpp) times the pin
+		// level functions one by one
+		friend class BROSE9323Profile;
+#endif
+		uint8_t _columnEntry(uint8_t, bool mirrored);
+		uint8_t _rowEntry(uint8_t, bool mirrored);
+		uint8_t _tileCount(void);
+		void _tileBounds(uint8_t, uint8_t& x0, uint8_t& w, uint8_t& y0, uint8_t& h);
+		void _dotAddress(uint8_t, uint8_t, uint8_t& panel, uint8_t& col, uint8_t& row);
 		void _selectColumn(uint8_t);
 		void _selectPanel(uint8_t);
 		void _selectRow(uint8_t);
 		void _setData(bool);
+		void _setEnable(bool);
 		void _strobe(void);
+		void _mergeDirty(void);
+		bool _drawnSinceWalk(void);
+		void _finishWalk(void);
+		void _startConverge(void);
+		void _converged(void);
+		void _resetCursor(FlipCursor&, bool);
+		bool _nextFlip(FlipCursor&, const uint8_t*, uint8_t&, uint8_t&, bool&);
+		bool _scanPause(FlipCursor&);
+		void _selectDot(uint8_t, uint8_t, bool);
+		void _commitDot(uint8_t, uint8_t, bool);
 #endif
+
+		enum BitmapMode : uint8_t {
+			BITMAP_PROGMEM = 1, // bitmap is in flash
+			BITMAP_BG      = 2  // clear bits are drawn in the background color
+		};
+
+		void _writeBits(int16_t, int16_t, uint8_t, uint8_t);
+		void _shiftRect(int16_t, int16_t, int16_t, int16_t, int16_t, int16_t, bool, uint16_t);
+		void _drawBitmap(int16_t, int16_t, const uint8_t*, int16_t, int16_t, uint16_t, uint16_t, uint8_t);
 	public:
 		BROSE9323(uint8_t, uint8_t, uint8_t, uint16_t ft = 280);
 		uint8_t* _old_buffer = NULL;
@@ -89,10 +416,271 @@ class BROSE9323 : public Adafruit_GFX {
 		void display(bool force = false);
 		void drawPixel(int16_t x, int16_t y, uint16_t color);
 		void fillScreen(uint16_t);
+		// Drawn a byte of _new_buffer at a time instead of pixel by pixel
+		void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+		void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+		void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+		void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
+		void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg);
+		void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color);
+		void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg);
+		// Moves the image by dx columns right and dy rows down. scroll fills
+		// the uncovered dots with fill, roll wraps them around. The Rect
+		// variants only move the dots inside the rectangle.
+		void scroll(int16_t dx, int16_t dy, uint16_t fill = 0);
+		void roll(int16_t dx, int16_t dy);
+		void scrollRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy, uint16_t fill = 0);
+		void rollRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy);
 		void setDirect(bool);
 		void setTiming(uint16_t);
+		uint16_t getTiming(void);
+		// Columns [x, x + w) changed, for code writing _new_buffer directly
+		void markDirty(int16_t x, int16_t w);
+		// Dots of _new_buffer whatever its layout. Writing does not mark them
+		// for display(), call markDirty() afterwards.
+		bool getBufferPixel(uint8_t x, uint8_t y) { return _dot(_new_buffer, x, y); }
+		void setBufferPixel(uint8_t x, uint8_t y, bool b) { _setDot(_new_buffer, x, y, b); }
+		// Byte offset of a row-major frame, 8 dots of a row with bit 0 for the
+		// leftmost, whatever the layout of _new_buffer. The frame protocol and
+		// the compositor exchange frames this way.
+		uint8_t getRowByte(uint16_t offset) {
+#ifdef BROSE9323_COLUMN_MAJOR
+			const uint8_t y = offset / _buffer_width;
+			const uint8_t x = (offset % _buffer_width) * 8;
+			uint8_t bits = 0;
+			for (uint8_t b = 0; b < 8 && x + b < width(); b++) {
+				if (_dot(_new_buffer, x + b, y)) bits |= 1 << b;
+			}
+			return bits;
+#else
+			return _new_buffer[offset];
+#endif
+		}
+		void setRowByte(uint16_t offset, uint8_t bits) {
+#ifdef BROSE9323_COLUMN_MAJOR
+			const uint8_t y = offset / _buffer_width;
+			const uint8_t x = (offset % _buffer_width) * 8;
+			for (uint8_t b = 0; b < 8 && x + b < width(); b++) {
+				_setDot(_new_buffer, x + b, y, bits & (1 << b));
+			}
+#else
+			_new_buffer[offset] = bits;
+#endif
+		}
+		// Rows 8 * i to 8 * i + 7 of column x, bit 0 for the topmost, whatever
+		// the layout. Animations are stored this way.
+		uint8_t getColumnByte(uint8_t x, uint8_t i) {
+#ifdef BROSE9323_COLUMN_MAJOR
+			return _new_buffer[2 * x + i];
+#else
+			uint8_t bits = 0;
+			for (uint8_t b = 0; b < 8 && 8 * i + b < height(); b++) {
+				if (_dot(_new_buffer, x, 8 * i + b)) bits |= 1 << b;
+			}
+			return bits;
+#endif
+		}
+		void setColumnByte(uint8_t x, uint8_t i, uint8_t bits) {
+#ifdef BROSE9323_COLUMN_MAJOR
+			_new_buffer[2 * x + i] = bits;
+#else
+			for (uint8_t b = 0; b < 8 && 8 * i + b < height(); b++) {
+				_setDot(_new_buffer, x, 8 * i + b, bits & (1 << b));
+			}
+#endif
+		}
+#ifdef BROSE9323_COUNTERS
+		Counters counters(void);
+		void resetCounters(void);
+#endif
 #ifndef ESP8266
 		void printBuffer(void);
+		void setScanOrder(ScanOrder);
+		// Counts what display() would do without touching the panel
+		FlipPlanStats planFlips(bool force = false);
+		// Incremental refresh: flips as many dots as fit into the budget and
+		// continues on the next call, _old_buffer always matches the panel
+		uint16_t displayFor(uint32_t budget_us);
+#ifndef BROSE9323_ASYNC
+		bool displayStep(void);
+#endif
+		// Dots that still differ from the panel
+		uint16_t pending(void);
+		// Caps the dots one display() flips, 0 for no cap. The rest is left
+		// for the next calls: a walk continues where the last call stopped
+		// and dots drawn meanwhile wait for the following walk, so every
+		// region gets its turn however often the frame changes.
+		void setFlipLimit(uint16_t);
+		uint16_t getFlipLimit(void);
+		// Microseconds from the display() that found the panel out of date
+		// until it matched the buffer again, for the last time it did
+		uint32_t convergenceMicros(void);
+#ifdef BROSE9323_ASYNC
+		// With BROSE9323_ASYNC display() only queues the frame. Timer1 flips
+		// the dots in the background, a newer frame replaces a queued one.
+		bool busy(void);
+		void waitIdle(void);
+		// Called from interrupt context once the queued frame is on the panel
+		void onFrameCommitted(void (*)(void));
+		// Advances the flip engine, returns microseconds until the next call
+		// or 0 when idle. Normally called by the Timer1 ISR.
+		uint16_t tick(void);
+#endif
 #endif
 };
+template <uint8_t... I> struct BROSE9323Indices {};
+template <uint8_t N, uint8_t... I> struct BROSE9323MakeIndices : BROSE9323MakeIndices<N - 1, N - 1, I...> {};
+template <uint8_t... I> struct BROSE9323MakeIndices<0, I...> {
+	typedef BROSE9323Indices<I...> type;
+};
+
+// Coil addresses of every column and row of a configuration, generated by
+// the compiler into flash
+template <uint8_t W, uint8_t H, uint8_t PANEL_W, uint8_t FLAGS,
+	class = typename BROSE9323MakeIndices<W>::type, class = typename BROSE9323MakeIndices<H>::type>
+struct BROSE9323AddressTable;
+
+template <uint8_t W, uint8_t H, uint8_t PANEL_W, uint8_t FLAGS, uint8_t... X, uint8_t... Y>
+struct BROSE9323AddressTable<W, H, PANEL_W, FLAGS, BROSE9323Indices<X...>, BROSE9323Indices<Y...> > {
+	static const uint8_t columns[W];
+	static const uint8_t rows[H];
+};
+
+template <uint8_t W, uint8_t H, uint8_t PANEL_W, uint8_t FLAGS, uint8_t... X, uint8_t... Y>
+const uint8_t BROSE9323AddressTable<W, H, PANEL_W, FLAGS, BROSE9323Indices<X...>, BROSE9323Indices<Y...> >::columns[W] PROGMEM = {
+	BROSE9323::columnEntry(X, W, PANEL_W, FLAGS)...
+};
+
+template <uint8_t W, uint8_t H, uint8_t PANEL_W, uint8_t FLAGS, uint8_t... X, uint8_t... Y>
+const uint8_t BROSE9323AddressTable<W, H, PANEL_W, FLAGS, BROSE9323Indices<X...>, BROSE9323Indices<Y...> >::rows[H] PROGMEM = {
+	BROSE9323::rowEntry(Y, H, FLAGS)...
+};
+
+// Coil addresses of a Layout, as wired and mirrored
+template <const BROSE9323::Layout& L, uint8_t W, uint8_t H,
+	class = typename BROSE9323MakeIndices<W>::type, class = typename BROSE9323MakeIndices<H>::type>
+struct BROSE9323LayoutTable;
+
+template <const BROSE9323::Layout& L, uint8_t W, uint8_t H, uint8_t... X, uint8_t... Y>
+struct BROSE9323LayoutTable<L, W, H, BROSE9323Indices<X...>, BROSE9323Indices<Y...> > {
+	static const uint8_t columns[2][W];
+	static const uint8_t rows[2][H];
+};
+
+template <const BROSE9323::Layout& L, uint8_t W, uint8_t H, uint8_t... X, uint8_t... Y>
+const uint8_t BROSE9323LayoutTable<L, W, H, BROSE9323Indices<X...>, BROSE9323Indices<Y...> >::columns[2][W] PROGMEM = {
+	{ BROSE9323::layoutColumnEntry(L, X, false)... },
+	{ BROSE9323::layoutColumnEntry(L, X, true)... }
+};
+
+template <const BROSE9323::Layout& L, uint8_t W, uint8_t H, uint8_t... X, uint8_t... Y>
+const uint8_t BROSE9323LayoutTable<L, W, H, BROSE9323Indices<X...>, BROSE9323Indices<Y...> >::rows[2][H] PROGMEM = {
+	{ BROSE9323::layoutRowEntry(L, Y, false)... },
+	{ BROSE9323::layoutRowEntry(L, Y, true)... }
+};
+
+// BROSE9323 with its size fixed at compile time. The buffers are a member
+// array, so a global display shows up in the linker map instead of the
+// heap, and drawPixel() indexes them with constants: no divisions and a
+// single compare per coordinate.
+template <uint8_t W, uint8_t H>
+class BROSE9323Sized : public BROSE9323 {
+	static_assert(W > 0 && H > 0, "empty display");
+#ifdef BROSE9323_COLUMN_MAJOR
+	static_assert(H <= 16, "BROSE9323_COLUMN_MAJOR keeps a column in 16 bits");
+#endif
+
+	private:
+		uint8_t _storage[BROSE9323_STORAGE_SIZE(W, H)];
+
+	protected:
+		BROSE9323Sized(uint8_t pw, uint16_t ft) :
+			BROSE9323(W, H, pw, ft, _storage) {
+		}
+
+	public:
+		static const uint8_t BUFFER_WIDTH = (W + 7) / 8;
+		static const uint16_t BUFFER_SIZE = BROSE9323_BUFFER_SIZE(W, H);
+
+		void drawPixel(int16_t x, int16_t y, uint16_t color) {
+			// Negative coordinates wrap around and fail the compare as well
+			if ((uint16_t)x >= W || (uint16_t)y >= H) return;
+			if (_direct_mode) {
+				BROSE9323::drawPixel(x, y, color);
+				return;
+			}
+#ifdef BROSE9323_COLUMN_MAJOR
+			uint8_t* p = _new_buffer + 2 * (uint8_t)x + ((uint8_t)y >> 3);
+			const uint8_t mask = 1 << (y & 7);
+#else
+			uint8_t* p = _new_buffer + (uint8_t)y * BUFFER_WIDTH + ((uint8_t)x >> 3);
+			const uint8_t mask = 1 << (x & 7);
+#endif
+			if ((bool)(*p & mask) == (bool)color) {
+				BROSE9323_COUNT(noop_pixels, 1);
+				return;
+			}
+			*p ^= mask;
+#ifndef ESP8266
+			_markChanged(x, y);
+#endif
+		}
+};
+
+template <uint8_t W, uint8_t H>
+const uint8_t BROSE9323Sized<W, H>::BUFFER_WIDTH;
+template <uint8_t W, uint8_t H>
+const uint16_t BROSE9323Sized<W, H>::BUFFER_SIZE;
+
+// A row of PANEL_W wide panels. Coil addresses come from a table in flash,
+// FLAGS mirrors them (see BROSE9323::Orientation).
+template <uint8_t W, uint8_t H, uint8_t PANEL_W, uint8_t FLAGS = 0>
+class BROSE9323Fixed : public BROSE9323Sized<W, H> {
+	static_assert(PANEL_W > 0, "empty panel");
+	static_assert(PANEL_W <= 28 && H <= 25, "more columns or rows than the address lines reach");
+	static_assert(W <= 8 * PANEL_W, "more panels than the panel address reaches");
+
+	public:
+		BROSE9323Fixed(uint16_t ft = 280) :
+			BROSE9323Sized<W, H>(PANEL_W, ft) {
+#ifndef ESP8266
+			this->_column_table = BROSE9323AddressTable<W, H, PANEL_W, FLAGS>::columns;
+			this->_row_table = BROSE9323AddressTable<W, H, PANEL_W, FLAGS>::rows;
+#endif
+		}
+};
+
+// Panels arranged by a Layout, which has to be a constexpr object:
+//
+//   constexpr BROSE9323::Layout wall = {
+//     4, 2, { 28, 28, 28, 28 }, { 16, 16 }, {
+//       BROSE9323::panel(0), BROSE9323::panel(1), BROSE9323::panel(2), BROSE9323::panel(3),
+//       BROSE9323::panel(4, BROSE9323::ROTATE_180), BROSE9323::panel(5, BROSE9323::ROTATE_180),
+//       BROSE9323::panel(6, BROSE9323::ROTATE_180), BROSE9323::panel(7, BROSE9323::ROTATE_180)
+//     }
+//   };
+//   BROSE9323Tiled<wall> display;
+//
+// display() flips panel by panel, the grid row by row.
+template <const BROSE9323::Layout& L>
+class BROSE9323Tiled : public BROSE9323Sized<BROSE9323::layoutSize(L.widths, L.columns), BROSE9323::layoutSize(L.heights, L.rows)> {
+	static const uint16_t W = BROSE9323::layoutSize(L.widths, L.columns);
+	static const uint16_t H = BROSE9323::layoutSize(L.heights, L.rows);
+
+	static_assert(L.columns > 0 && L.rows > 0 && L.columns * L.rows <= 8, "more panels than the panel address reaches");
+	static_assert(W <= 255 && H <= 255, "display too large");
+	static_assert(BROSE9323::layoutMax(L.widths, L.columns) <= 28 && BROSE9323::layoutMax(L.heights, L.rows) <= 25,
+		"more columns or rows than the address lines reach");
+
+	public:
+		BROSE9323Tiled(uint16_t ft = 280) :
+			BROSE9323Sized<W, H>(L.widths[0], ft) {
+#ifndef ESP8266
+			this->_column_table = &BROSE9323LayoutTable<L, W, H>::columns[0][0];
+			this->_row_table = &BROSE9323LayoutTable<L, W, H>::rows[0][0];
+			this->_layout = &L;
+#endif
+		}
+};
+
 #endif //BROSE9323_H
@@ -0,0 +1,86 @@
+#ifndef BROSE9323_IO_H
+#define BROSE9323_IO_H
+
+#include <Arduino.h>
+
+// Direct port register backend for the address, data and strobe lines.
+//
+// On the ATmega328P/168 (Uno, Nano, Pro Mini) every Arduino pin maps to a
+// fixed port bit: D0-D7 are PORTD0-7, D8-D13 are PORTB0-5 and A0-A5 are
+// PORTC0-5. As the pin assignment is known at compile time, a whole COL_x,
+// ROW_x or ADDR_x group can be written with a single read-modify-write per
+// port instead of one digitalWrite() per line.
+//
+// Define BROSE9323_DIGITALWRITE to force the portable digitalWrite() path.
+#if !defined(BROSE9323_DIGITALWRITE) && (defined(__AVR_ATmega328P__) || \
+	defined(__AVR_ATmega168P__) || defined(__AVR_ATmega168PB__) || defined(__AVR_ATmega168__))
+#define BROSE9323_PORT_IO
+#endif
+
+#ifdef BROSE9323_PORT_IO
+
+// Host builds may point these at mock registers
+#ifndef BROSE9323_PORTB
+#define BROSE9323_PORTB PORTB
+#endif
+#ifndef BROSE9323_PORTC
+#define BROSE9323_PORTC PORTC
+#endif
+#ifndef BROSE9323_PORTD
+#define BROSE9323_PORTD PORTD
+#endif
+
+#define BROSE9323_NO_PIN 0xFF
+
+#define BROSE9323_PIN_PORT(pin) ((pin) == BROSE9323_NO_PIN ? 0 : (pin) < 8 ? 'D' : (pin) < 14 ? 'B' : 'C')
+#define BROSE9323_PIN_MASK(pin) (1 << ((pin) < 8 ? (pin) : (pin) < 14 ? (pin) - 8 : (pin) - 14))
+
+// Mask of pin in port if on is set, 0 otherwise
+static inline __attribute__((always_inline)) uint8_t _brosePinBits(char port, uint8_t pin, bool on) {
+	return (BROSE9323_PIN_PORT(pin) == port && on) ? BROSE9323_PIN_MASK(pin) : 0;
+}
+
+// Bits of value (LSB first) as they appear on one port for pins p0..p4
+static inline __attribute__((always_inline)) uint8_t _brosePortBits(char port, uint8_t value,
+		uint8_t p0, uint8_t p1, uint8_t p2, uint8_t p3, uint8_t p4) {
+	return _brosePinBits(port, p0, value &  1) |
+		   _brosePinBits(port, p1, value &  2) |
+		   _brosePinBits(port, p2, value &  4) |
+		   _brosePinBits(port, p3, value &  8) |
+		   _brosePinBits(port, p4, value & 16);
+}
+
+// Writes value (LSB first) to the pins p0..p4 with one update per port.
+// Unused trailing pins are BROSE9323_NO_PIN. Ports without any of the pins
+// are not touched at all, the masks fold to constants.
+static inline __attribute__((always_inline)) void broseWritePins(uint8_t value,
+		uint8_t p0, uint8_t p1 = BROSE9323_NO_PIN, uint8_t p2 = BROSE9323_NO_PIN,
+		uint8_t p3 = BROSE9323_NO_PIN, uint8_t p4 = BROSE9323_NO_PIN) {
+	const uint8_t mask_b = _brosePortBits('B', 0xFF, p0, p1, p2, p3, p4);
+	const uint8_t mask_c = _brosePortBits('C', 0xFF, p0, p1, p2, p3, p4);
+	const uint8_t mask_d = _brosePortBits('D', 0xFF, p0, p1, p2, p3, p4);
+	uint8_t oldSREG = SREG;
+	cli();
+	if (mask_b) BROSE9323_PORTB = (BROSE9323_PORTB & ~mask_b) | _brosePortBits('B', value, p0, p1, p2, p3, p4);
+	if (mask_c) BROSE9323_PORTC = (BROSE9323_PORTC & ~mask_c) | _brosePortBits('C', value, p0, p1, p2, p3, p4);
+	if (mask_d) BROSE9323_PORTD = (BROSE9323_PORTD & ~mask_d) | _brosePortBits('D', value, p0, p1, p2, p3, p4);
+	SREG = oldSREG;
+}
+
+// Single line, compiles to one sbi/cbi
+static inline __attribute__((always_inline)) void broseWritePin(uint8_t pin, bool value) {
+	switch (BROSE9323_PIN_PORT(pin)) {
+		case 'B':
+			if (value) BROSE9323_PORTB |= BROSE9323_PIN_MASK(pin); else BROSE9323_PORTB &= ~BROSE9323_PIN_MASK(pin);
+			break;
+		case 'C':
+			if (value) BROSE9323_PORTC |= BROSE9323_PIN_MASK(pin); else BROSE9323_PORTC &= ~BROSE9323_PIN_MASK(pin);
+			break;
+		case 'D':
+			if (value) BROSE9323_PORTD |= BROSE9323_PIN_MASK(pin); else BROSE9323_PORTD &= ~BROSE9323_PIN_MASK(pin);
+			break;
+	}
+}
+
+#endif //BROSE9323_PORT_IO
+#endif //BROSE9323_IO_H
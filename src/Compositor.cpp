@@ -0,0 +1,93 @@
+#include "Compositor.h"
+
+Layer::Layer(uint8_t w, uint8_t h, uint8_t* storage, Blend op) :
+	Adafruit_GFX(w, h),
+	_buffer(storage),
+	_buffer_width((w + 7) / 8),
+	_buffer_size(_buffer_width * h),
+	_blend(op) {
+	memset(_buffer, 0, _buffer_size);
+}
+
+void Layer::drawPixel(int16_t x, int16_t y, uint16_t color) {
+	if ((uint16_t)x >= (uint16_t)width() || (uint16_t)y >= (uint16_t)height()) return;
+	uint8_t* p = _buffer + y * _buffer_width + x / 8;
+	if (color) {
+		*p |= 1 << (x & 7);
+	} else {
+		*p &= ~(1 << (x & 7));
+	}
+}
+
+void Layer::fillScreen(uint16_t color) {
+	memset(_buffer, color ? 0xFF : 0x00, _buffer_size);
+}
+
+void Layer::blit(int16_t x, int16_t y, const uint8_t* sprite, uint8_t w, uint8_t h, Blend op) {
+	_blit(x, y, sprite, w, h, op, false);
+}
+
+void Layer::blit_P(int16_t x, int16_t y, const uint8_t* sprite, uint8_t w, uint8_t h, Blend op) {
+	_blit(x, y, sprite, w, h, op, true);
+}
+
+void Layer::_blit(int16_t x, int16_t y, const uint8_t* sprite, uint8_t w, uint8_t h, Blend op, bool progmem) {
+	const uint8_t sprite_width = (w + 7) / 8;
+	const uint8_t last_mask = (w & 7) ? (1 << (w & 7)) - 1 : 0xFF;
+	for (uint8_t j = 0; j < h; j++, sprite += sprite_width) {
+		if ((uint16_t)(y + j) >= (uint16_t)height()) continue;
+		uint8_t* row = _buffer + (y + j) * _buffer_width;
+		for (uint8_t i = 0; i < sprite_width; i++) {
+			const uint8_t bits = progmem ? pgm_read_byte(sprite + i) : sprite[i];
+			_blendBits(row, x + 8 * i, bits, i + 1 == sprite_width ? last_mask : 0xFF, op);
+		}
+	}
+}
+
+// Blends 8 bits starting at column x into a row, they straddle two bytes
+// unless x is a multiple of 8. Columns outside the layer are skipped.
+void Layer::_blendBits(uint8_t* row, int16_t x, uint8_t bits, uint8_t mask, Blend op) {
+	if (x <= -8 || x >= width()) return;
+	const int16_t i = x >> 3;
+	const uint8_t shift = x & 7;
+	if (i >= 0) {
+		row[i] = blend(row[i], bits << shift, mask << shift, op);
+	}
+	if (shift && i + 1 < _buffer_width) {
+		row[i + 1] = blend(row[i + 1], bits >> (8 - shift), mask >> (8 - shift), op);
+	}
+}
+
+Compositor::Compositor(BROSE9323& display, Layer* const* layers, uint8_t count) :
+	_display(display),
+	_layers(layers),
+	_count(count) {
+}
+
+uint16_t Compositor::flatten(void) {
+	const uint8_t buffer_width = (_display.width() + 7) / 8;
+	// Bits past the right edge are not dots
+	const uint8_t last_mask = 0xFF >> (7 - ((_display.width() - 1) & 7));
+	uint16_t changed = 0;
+	uint16_t offset = 0;
+	for (int16_t y = 0; y < _display.height(); y++) {
+		for (uint8_t i = 0; i < buffer_width; i++, offset++) {
+			uint8_t bits = 0;
+			for (uint8_t l = 0; l < _count; l++) {
+				if (_layers[l]->visible()) {
+					bits = Layer::blend(bits, _layers[l]->buffer()[offset], 0xFF, _layers[l]->getBlend());
+				}
+			}
+
+			// Only the dots that differ go through drawPixel(), which marks
+			// them for display()
+			uint8_t diff = (bits ^ _display.getRowByte(offset)) & (i + 1 == buffer_width ? last_mask : 0xFF);
+			for (uint8_t b = 0; diff; b++, diff >>= 1) {
+				if (!(diff & 1)) continue;
+				_display.drawPixel(8 * i + b, y, bits & (1 << b));
+				changed++;
+			}
+		}
+	}
+	return changed;
+}
@@ -0,0 +1,90 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <BROSE9323.h>
+
+// A 1 bit drawing surface in the row-major layout of the frame protocol:
+// rows of (width + 7) / 8 bytes, bit 0 of a byte is its leftmost dot.
+// Drawing only changes the layer, Compositor::flatten() brings it to the
+// display.
+class Layer : public Adafruit_GFX {
+	public:
+		// How a layer or sprite combines with what is below it
+		enum Blend : uint8_t {
+			BLEND_COPY, // replaces it
+			BLEND_OR,   // adds its set dots
+			BLEND_AND,  // keeps only the dots it has set as well
+			BLEND_XOR,  // inverts the dots it has set
+			BLEND_MASK  // clears the dots it has set
+		};
+
+	private:
+		uint8_t* const _buffer;
+		const uint8_t _buffer_width;
+		const uint16_t _buffer_size;
+		Blend _blend;
+		bool _visible = true;
+
+		void _blendBits(uint8_t* row, int16_t x, uint8_t bits, uint8_t mask, Blend);
+		void _blit(int16_t, int16_t, const uint8_t*, uint8_t, uint8_t, Blend, bool progmem);
+
+	protected:
+		// Uses storage of (w + 7) / 8 * h bytes
+		Layer(uint8_t w, uint8_t h, uint8_t* storage, Blend);
+
+	public:
+		// Combines the bits of src selected by mask into dst
+		static uint8_t blend(uint8_t dst, uint8_t src, uint8_t mask, Blend op) {
+			switch (op) {
+				case BLEND_COPY: return (dst & ~mask) | (src & mask);
+				case BLEND_OR:   return dst | (src & mask);
+				case BLEND_AND:  return dst & (src | ~mask);
+				case BLEND_XOR:  return dst ^ (src & mask);
+				case BLEND_MASK: return dst & ~(src & mask);
+			}
+			return dst;
+		}
+
+		uint8_t* buffer(void) { return _buffer; }
+		uint8_t bufferWidth(void) { return _buffer_width; }
+		Blend getBlend(void) { return _blend; }
+		void setBlend(Blend op) { _blend = op; }
+		bool visible(void) { return _visible; }
+		void setVisible(bool visible) { _visible = visible; }
+
+		void drawPixel(int16_t x, int16_t y, uint16_t color);
+		void fillScreen(uint16_t color);
+		// Combines a w x h sprite in the layer's own bit order (a Layer's
+		// buffer is one) with the dots at x, y, a byte at a time
+		void blit(int16_t x, int16_t y, const uint8_t* sprite, uint8_t w, uint8_t h, Blend op = BLEND_OR);
+		// The same for a sprite in flash
+		void blit_P(int16_t x, int16_t y, const uint8_t* sprite, uint8_t w, uint8_t h, Blend op = BLEND_OR);
+};
+
+// Layer with its storage as a member array
+template <uint8_t W, uint8_t H>
+class StaticLayer : public Layer {
+	private:
+		uint8_t _storage[(W + 7) / 8 * H];
+
+	public:
+		StaticLayer(Blend op = BLEND_OR) : Layer(W, H, _storage, op) {}
+};
+
+// Stacks layers of the display's size onto the display. flatten() blends
+// the visible layers bottom up, starting from a blank frame, and changes
+// only the dots of _new_buffer whose blended value differs, so display()
+// has no more to flip than what really changed on the panel.
+class Compositor {
+	private:
+		BROSE9323& _display;
+		Layer* const* _layers;
+		const uint8_t _count;
+
+	public:
+		// layers[0] is the bottom one
+		Compositor(BROSE9323&, Layer* const* layers, uint8_t count);
+		// Returns the number of dots changed
+		uint16_t flatten(void);
+};
+#endif //COMPOSITOR_H
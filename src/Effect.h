@@ -0,0 +1,33 @@
+#ifndef EFFECT_H
+#define EFFECT_H
+
+#include <stdint.h>
+
+// An animation run by the EffectScheduler. tick() only draws into the
+// display buffer, the scheduler flips the dots and paces the frames.
+class Effect {
+	private:
+		const char* const _name;
+		const bool _incremental;
+	protected:
+		uint16_t _frame_ms;
+	public:
+		// An incremental effect gets as many dots flipped as fit into its frame
+		// period and the rest later, the others get every frame on the panel
+		// completely even if that takes longer than the period
+		Effect(const char* name, uint16_t frame_ms, bool incremental = false) :
+			_name(name), _incremental(incremental), _frame_ms(frame_ms) {}
+		const char* name(void) { return _name; }
+		bool incremental(void) { return _incremental; }
+		// Frame period, an effect may change it from one frame to the next
+		uint16_t frameMs(void) { return _frame_ms; }
+
+		// Called before the first frame
+		virtual void begin(void) {}
+		// Draws the frame starting at now (millis()). Returns false once the
+		// effect has nothing more to show.
+		virtual bool tick(unsigned long now) = 0;
+		// Called after the last frame
+		virtual void end(void) {}
+};
+#endif //EFFECT_H
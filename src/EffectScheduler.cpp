@@ -0,0 +1,83 @@
+#include "EffectScheduler.h"
+
+EffectScheduler::EffectScheduler(BROSE9323& display, Effect* const* effects, uint8_t count, unsigned long duration_ms) :
+	_display(display),
+	_effects(effects),
+	_count(count),
+	_rotation(count),
+	_duration(duration_ms) {
+}
+
+void EffectScheduler::setRotation(uint8_t count) {
+	_rotation = count > 0 && count <= _count ? count : _count;
+}
+
+void EffectScheduler::select(uint8_t i) {
+	if (i >= _count) return;
+	_next = i;
+	_switch = true;
+}
+
+void EffectScheduler::restart(void) {
+	if (_running) _effects[_current]->end();
+	_running = false;
+	_next = _current;
+	_switch = true;
+}
+
+bool EffectScheduler::run(void) {
+	const uint32_t now = micros();
+	if (_running && now - _frame_start < _frame_us) return false;
+
+	if (!_running) {
+		_begin(_next, now);
+	} else if (_switch || _done || millis() - _effect_start >= _duration) {
+		_effects[_current]->end();
+		uint8_t next = _current + 1 < _rotation ? _current + 1 : 0;
+		if (_switch) next = _next;
+		_begin(next, now);
+	} else {
+		// Frames are due on a fixed grid, a late frame moves the grid instead
+		// of being followed by a burst of frames that catch up
+		_frame_start += _frame_us;
+		if (now - _frame_start >= _frame_us) _frame_start = now;
+	}
+
+	Effect* effect = _effects[_current];
+	_frame_us = effect->frameMs() * 1000UL;
+	_done = !effect->tick(millis());
+
+	const uint32_t start = micros();
+#ifdef ESP8266
+	_display.display();
+	_pending = 0;
+#else
+	if (effect->incremental()) {
+		// What tick() left of the period goes to flipping dots. A frame that
+		// is late already still gets a quarter period, or a slow tick() would
+		// keep the panel from ever catching up.
+		const uint32_t used = start - _frame_start;
+		uint32_t budget = used < _frame_us ? _frame_us - used : 0;
+		if (budget < _frame_us / 4) budget = _frame_us / 4;
+		_pending = _display.displayFor(budget);
+	} else {
+		_display.display();
+		_pending = _display.getFlipLimit() ? _display.pending() : 0;
+	}
+#endif
+	_display_us = micros() - start;
+
+	_frames++;
+	if (micros() - _frame_start > _frame_us) _overruns++;
+	return true;
+}
+
+void EffectScheduler::_begin(uint8_t i, uint32_t now) {
+	_current = i;
+	_switch = false;
+	_done = false;
+	_running = true;
+	_effect_start = millis();
+	_frame_start = now;
+	_effects[i]->begin();
+}
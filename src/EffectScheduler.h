@@ -0,0 +1,59 @@
+#ifndef EFFECTSCHEDULER_H
+#define EFFECTSCHEDULER_H
+
+#include <BROSE9323.h>
+#include "Effect.h"
+
+// Runs a registry of effects one after the other at their frame rate.
+// run() never waits: it returns at once until the next frame is due, so
+// the caller keeps polling serial in between. A frame is the effect's
+// tick() followed by display(), the time both took is subtracted from the
+// wait for the next frame. For an incremental effect only as many dots are
+// flipped as fit into the rest of the period, the others are flipped in
+// the next frames, so its speed does not depend on how many dots change.
+class EffectScheduler {
+	private:
+		BROSE9323& _display;
+		Effect* const* _effects;
+		const uint8_t _count;
+		uint8_t _rotation;
+		const unsigned long _duration;
+		uint8_t _current = 0;
+		uint8_t _next = 0;
+		bool _switch = false;        // select() asked for _next
+		bool _running = false;       // _effects[_current] has begun
+		bool _done = false;          // its last tick() returned false
+		unsigned long _effect_start; // millis()
+		uint32_t _frame_start;       // micros() the current frame was due
+		uint32_t _frame_us = 0;
+		uint32_t _frames = 0;
+		uint32_t _overruns = 0;
+		uint32_t _display_us = 0;
+		uint16_t _pending = 0;
+
+		void _begin(uint8_t, uint32_t);
+	public:
+		// Each effect runs for duration_ms or until its tick() returns false
+		EffectScheduler(BROSE9323&, Effect* const* effects, uint8_t count, unsigned long duration_ms);
+		// Only the first count effects take part in the rotation, the others
+		// run when selected and are followed by the first one
+		void setRotation(uint8_t count);
+		// Switches to an effect at the next frame boundary
+		void select(uint8_t);
+		// Begins the current effect again, for when something else has drawn
+		// on the display in the meantime
+		void restart(void);
+		// Runs a frame if one is due. Returns true if it did.
+		bool run(void);
+
+		uint8_t count(void) { return _count; }
+		uint8_t current(void) { return _current; }
+		Effect* effect(uint8_t i) { return _effects[i]; }
+		// Frames run, and frames that took longer than their period
+		uint32_t frames(void) { return _frames; }
+		uint32_t overruns(void) { return _overruns; }
+		// Time the last frame spent flipping dots, and the dots it left over
+		uint32_t displayMicros(void) { return _display_us; }
+		uint16_t pending(void) { return _pending; }
+};
+#endif //EFFECTSCHEDULER_H
@@ -0,0 +1,178 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include "Effect.h"
+
+// Effects that draw only through the canvas they are given, so the same
+// code runs on the controller with a BROSE9323 and on the host renderer
+// (src/host/fliprender.cpp) with a HostCanvas. A canvas provides width(),
+// height(), drawPixel(), fillScreen(), drawFastHLine(), drawFastVLine()
+// and scroll() as BROSE9323 does. Passing the concrete display type lets
+// the compiler call its drawPixel() directly.
+
+// xorshift32. Unlike Arduino's random() it needs no 32 bit division, and
+// it gives the same sequence on every platform for the same seed.
+class EffectRandom {
+	private:
+		static uint32_t& _state(void) {
+			static uint32_t state = 2463534242UL;
+			return state;
+		}
+	public:
+		static void seed(uint32_t seed) { _state() = seed ? seed : 1; }
+		static uint32_t next(void) {
+			uint32_t& x = _state();
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			return x;
+		}
+		// [0, n)
+		static uint16_t below(uint16_t n) { return ((next() & 0xFFFF) * n) >> 16; }
+		// [lo, hi)
+		static int16_t between(int16_t lo, int16_t hi) { return lo + below(hi - lo); }
+};
+
+template <class Canvas>
+class RandomFlipEffect : public Effect {
+	private:
+		Canvas& _canvas;
+	public:
+		RandomFlipEffect(Canvas& canvas) : Effect("randomFlip", 40, true), _canvas(canvas) {}
+
+		bool tick(unsigned long) {
+			// Flip a random number of dots (between 5 and 99)
+			const uint8_t dots = EffectRandom::between(5, 100);
+			for (uint8_t i = 0; i < dots; i++) {
+				_canvas.drawPixel(EffectRandom::below(_canvas.width()), EffectRandom::below(_canvas.height()),
+					EffectRandom::below(2));
+			}
+			return true;
+		}
+};
+
+template <class Canvas>
+class RandomFlickerEffect : public Effect {
+	private:
+		Canvas& _canvas;
+	public:
+		RandomFlickerEffect(Canvas& canvas) : Effect("randomFlicker", 60), _canvas(canvas) {}
+
+		bool tick(unsigned long) {
+			// Entire screen black or white, for 20-100ms
+			_canvas.fillScreen(EffectRandom::below(2));
+			_frame_ms = EffectRandom::between(20, 101);
+			return true;
+		}
+};
+
+template <class Canvas>
+class SweepEffect : public Effect {
+	private:
+		Canvas& _canvas;
+		uint8_t _column = 0;
+	public:
+		SweepEffect(Canvas& canvas) : Effect("sweep", 50), _canvas(canvas) {}
+
+		void begin(void) {
+			// Alternating columns
+			for (int16_t x = 0; x < _canvas.width(); x++) {
+				_canvas.drawFastVLine(x, 0, _canvas.height(), (x % 2) ? 0 : 1);
+			}
+		}
+
+		bool tick(unsigned long) {
+			// Shift all columns one step to the right, the next color enters
+			// on the left
+			_canvas.scroll(1, 0);
+			_canvas.drawFastVLine(0, 0, _canvas.height(), (_column % 2) ? 0 : 1);
+			_column++;
+			return true;
+		}
+};
+
+template <class Canvas>
+class LinesEffect : public Effect {
+	private:
+		Canvas& _canvas;
+	public:
+		LinesEffect(Canvas& canvas) : Effect("lines", 10), _canvas(canvas) {}
+
+		bool tick(unsigned long) {
+			// Randomly set or clear whole columns across the entire width
+			for (int16_t x = 0; x < _canvas.width(); x++) {
+				if (EffectRandom::below(2)) {
+					_canvas.drawFastVLine(x, 0, _canvas.height(), EffectRandom::below(2));
+				}
+			}
+			_frame_ms = EffectRandom::between(1, 10);
+			return true;
+		}
+};
+
+// Rain drops with fading trails, at most DROPS of them (half the width)
+template <class Canvas, uint8_t DROPS = 42>
+class MatrixEffect : public Effect {
+	private:
+		struct RainDrop {
+			uint8_t x;
+			int16_t y;  // rows above the top are negative
+			uint8_t speed;
+			uint8_t brightness;
+		};
+
+		Canvas& _canvas;
+		RainDrop _drops[DROPS];
+
+		uint8_t _count(void) {
+			return _canvas.width() / 2 < DROPS ? _canvas.width() / 2 : DROPS;
+		}
+
+		void _reset(RainDrop& drop) {
+			drop.y = EffectRandom::between(-_canvas.height(), 0);
+			drop.speed = EffectRandom::between(1, 4);
+			drop.brightness = EffectRandom::between(1, 3);
+		}
+	public:
+		MatrixEffect(Canvas& canvas) : Effect("matrix", 100, true), _canvas(canvas) {}
+
+		void begin(void) {
+			for (uint8_t i = 0; i < _count(); i++) {
+				_drops[i].x = EffectRandom::below(_canvas.width());
+				_reset(_drops[i]);
+			}
+		}
+
+		bool tick(unsigned long) {
+			_canvas.fillScreen(0);
+
+			for (uint8_t i = 0; i < _count(); i++) {
+				// Move the drop down, back to the top once it left the screen
+				RainDrop& drop = _drops[i];
+				drop.y += drop.speed;
+				if (drop.y >= _canvas.height()) _reset(drop);
+
+				// Trail, fading along its length
+				for (int8_t trail = 0; trail < 8; trail++) {
+					const int16_t y = drop.y - trail;
+					if (y >= 0 && y < _canvas.height() && drop.brightness > trail / 2) {
+						_canvas.drawPixel(drop.x, y, 1);
+					}
+				}
+			}
+
+			// Flash a horizontal line in 5% of the frames
+			if (EffectRandom::below(100) < 5) {
+				_canvas.drawFastHLine(0, EffectRandom::below(_canvas.height()), _canvas.width(), 1);
+			}
+
+			// Up to 3 sparkles, each with a 10% chance
+			for (uint8_t i = 0; i < 3; i++) {
+				if (EffectRandom::below(100) < 10) {
+					_canvas.drawPixel(EffectRandom::below(_canvas.width()), EffectRandom::below(_canvas.height()), 1);
+				}
+			}
+			return true;
+		}
+};
+#endif //EFFECTS_H
@@ -0,0 +1,88 @@
+#include "FrameProtocol.h"
+
+#include <string.h>
+
+uint16_t frameCrc16(uint16_t crc, uint8_t data) {
+	crc ^= (uint16_t)data << 8;
+	for (uint8_t i = 0; i < 8; i++) {
+		crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+	return crc;
+}
+
+uint16_t frameBuild(uint8_t type, uint8_t seq, const uint8_t* payload, uint16_t len, uint8_t* out) {
+	out[0] = FRAME_SYNC;
+	out[1] = type;
+	out[2] = seq;
+	out[3] = len & 0xFF;
+	out[4] = len >> 8;
+	memmove(out + FRAME_HEADER_SIZE, payload, len);
+
+	uint16_t crc = 0xFFFF;
+	for (uint16_t i = 1; i < FRAME_HEADER_SIZE + len; i++) {
+		crc = frameCrc16(crc, out[i]);
+	}
+	out[FRAME_HEADER_SIZE + len] = crc & 0xFF;
+	out[FRAME_HEADER_SIZE + len + 1] = crc >> 8;
+	return len + FRAME_OVERHEAD;
+}
+
+static inline uint8_t _frameDiff(const uint8_t* prev, const uint8_t* next, uint16_t i) {
+	return prev ? prev[i] ^ next[i] : next[i];
+}
+
+uint16_t frameEncodeRLE(const uint8_t* prev, const uint8_t* next, uint16_t size, uint8_t* out, uint16_t out_size) {
+	uint16_t len = 0;
+	uint16_t i = 0;
+	while (i < size) {
+		uint8_t run = 0;
+		if (_frameDiff(prev, next, i)) {
+			// A single unchanged byte costs less inside a literal run than
+			// a skip token plus a new literal token
+			while (i + run < size && run < 128 && (_frameDiff(prev, next, i + run) ||
+					(i + run + 1 < size && _frameDiff(prev, next, i + run + 1)))) {
+				run++;
+			}
+			if (len + 1 + run > out_size) return FRAME_RLE_OVERFLOW;
+			out[len++] = 0x80 | (run - 1);
+			for (uint8_t j = 0; j < run; j++) {
+				out[len++] = _frameDiff(prev, next, i + j);
+			}
+		} else {
+			while (i + run < size && run < 128 && !_frameDiff(prev, next, i + run)) {
+				run++;
+			}
+			// Nothing changes up to the end
+			if (i + run == size) break;
+			if (len + 1 > out_size) return FRAME_RLE_OVERFLOW;
+			out[len++] = run - 1;
+		}
+		i += run;
+	}
+	return len;
+}
+
+uint16_t frameEncodeColumns(const uint8_t* prev, const uint8_t* next, uint8_t width, uint8_t height, uint8_t* out) {
+	const uint8_t buffer_width = (width + 7) / 8;
+	const uint8_t column_size = (height + 7) / 8;
+	uint16_t len = buffer_width;
+
+	memset(out, 0, buffer_width);
+	for (uint8_t x = 0; x < width; x++) {
+		const uint8_t bit = 1 << (x & 7);
+		// Built in place, only kept if the column changed
+		uint8_t* column = out + len;
+		bool changed = prev == NULL;
+		memset(column, 0, column_size);
+		for (uint8_t y = 0; y < height; y++) {
+			const uint16_t i = y * buffer_width + x / 8;
+			if (next[i] & bit) column[y / 8] |= 1 << (y & 7);
+			if (prev && ((prev[i] ^ next[i]) & bit)) changed = true;
+		}
+		if (changed) {
+			out[x / 8] |= bit;
+			len += column_size;
+		}
+	}
+	return len;
+}
@@ -0,0 +1,79 @@
+#ifndef FRAMEPROTOCOL_H
+#define FRAMEPROTOCOL_H
+
+#include <stdint.h>
+
+// Binary frame streaming protocol
+//
+// Every message is framed as
+//
+//   SYNC | TYPE | SEQ | LEN_LO | LEN_HI | PAYLOAD[LEN] | CRC_LO | CRC_HI
+//
+// with a CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF) over TYPE,
+// SEQ, LEN and PAYLOAD. Frame payloads use the BROSE9323 buffer layout: rows of
+// (width + 7) / 8 bytes, bit 0 of a byte is its leftmost pixel.
+//
+// COLUMNS payloads start with a bitmap of (width + 7) / 8 bytes in the same
+// bit order as a buffer row, one bit per column sent. It is followed by one
+// column word of (height + 7) / 8 bytes for every set bit, left to right;
+// bit (y & 7) of byte y / 8 of a column word is the dot in row y.
+//
+// RLE payloads are a sequence of tokens applied to the buffer from the
+// start. A token 0x00-0x7F skips n + 1 bytes, a token 0x80-0xFF is
+// followed by (n & 0x7F) + 1 literal bytes that are XORed into the buffer.
+//
+// The host sends one frame and waits for the ACK before the next one. The
+// ACK carries the SEQ of the message it answers; the host counts SEQ up
+// with every message and ignores ACKs with another SEQ, so an ACK that
+// comes in after the host gave up waiting is not taken for the next
+// message's. An ACK with a status other than FRAME_OK, or none in time,
+// means the controller's buffer is no longer known, the host has to send
+// a key frame next.
+
+#define FRAME_SYNC 0xA5
+
+enum FrameType : uint8_t {
+	FRAME_FULL    = 0x01, // raw buffer
+	FRAME_DELTA   = 0x02, // RLE of the XOR against the previous frame
+	FRAME_KEY_RLE = 0x03, // RLE of the frame itself, applied to a cleared buffer
+	FRAME_HELLO   = 0x04, // host asks for an ACK to sync up
+	FRAME_COLUMNS = 0x05, // changed-column bitmap and the changed columns
+	FRAME_ACK     = 0x10  // controller to host: status, window
+};
+
+enum FrameStatus : uint8_t {
+	FRAME_OK,
+	FRAME_PENDING,     // message not complete yet
+	FRAME_BAD_CRC,
+	FRAME_BAD_LENGTH,
+	FRAME_BAD_TYPE
+};
+
+#define FRAME_HEADER_SIZE   5
+#define FRAME_OVERHEAD      (FRAME_HEADER_SIZE + 2)
+// RLE payload size for a buffer that does not compress at all
+#define FRAME_RLE_MAX(size) ((size) + ((size) + 127) / 128)
+
+uint16_t frameCrc16(uint16_t crc, uint8_t data);
+
+// Writes a complete message to out, which must hold len + FRAME_OVERHEAD
+// bytes. The payload may already be in place at out + FRAME_HEADER_SIZE.
+// Returns the message size.
+uint16_t frameBuild(uint8_t type, uint8_t seq, const uint8_t* payload, uint16_t len, uint8_t* out);
+
+#define FRAME_RLE_OVERFLOW 0xFFFF
+
+// RLE encodes prev XOR next (prev may be NULL for a key frame) into out.
+// Returns the payload size or FRAME_RLE_OVERFLOW if it does not fit into
+// out_size. Identical frames encode to an empty payload.
+uint16_t frameEncodeRLE(const uint8_t* prev, const uint8_t* next, uint16_t size, uint8_t* out, uint16_t out_size);
+
+// COLUMNS payload size with every column sent
+#define FRAME_COLUMNS_MAX(width, height) (((width) + 7) / 8 + (width) * (((height) + 7) / 8))
+
+// Encodes the columns that differ between prev and next (prev may be NULL
+// to send all columns) into out, which must hold FRAME_COLUMNS_MAX bytes.
+// Returns the payload size, (width + 7) / 8 if no column changed.
+uint16_t frameEncodeColumns(const uint8_t* prev, const uint8_t* next, uint8_t width, uint8_t height, uint8_t* out);
+
+#endif //FRAMEPROTOCOL_H
@@ -0,0 +1,180 @@
+#include "FrameReceiver.h"
+
+FrameReceiver::FrameReceiver(BROSE9323& display) :
+	_display(display),
+	_buffer_width((display.width() + 7) / 8),
+	_buffer_size(_buffer_width * display.height()),
+	_column_size((display.height() + 7) / 8) {
+	_columns = (uint8_t*) calloc(_buffer_width, sizeof(uint8_t));
+}
+
+FrameStatus FrameReceiver::feed(uint8_t c) {
+	switch (_state) {
+		case WAIT_SYNC:
+			if (c == FRAME_SYNC) _state = WAIT_TYPE;
+			return FRAME_PENDING;
+		case WAIT_TYPE:
+			_type = c;
+			_crc = frameCrc16(0xFFFF, c);
+			_state = WAIT_SEQ;
+			return FRAME_PENDING;
+		case WAIT_SEQ:
+			_seq = c;
+			_crc = frameCrc16(_crc, c);
+			_state = WAIT_LEN_LO;
+			return FRAME_PENDING;
+		case WAIT_LEN_LO:
+			_length = c;
+			_crc = frameCrc16(_crc, c);
+			_state = WAIT_LEN_HI;
+			return FRAME_PENDING;
+		case WAIT_LEN_HI: {
+			_length |= (uint16_t)c << 8;
+			_crc = frameCrc16(_crc, c);
+			FrameStatus status = _header();
+			if (status != FRAME_OK) {
+				_state = WAIT_SYNC;
+				return status;
+			}
+			_state = _length ? WAIT_PAYLOAD : WAIT_CRC_LO;
+			return FRAME_PENDING;
+		}
+		case WAIT_PAYLOAD:
+			_crc = frameCrc16(_crc, c);
+			_payload(c);
+			if (++_received == _length) _state = WAIT_CRC_LO;
+			return FRAME_PENDING;
+		case WAIT_CRC_LO:
+			_frame_crc = c;
+			_state = WAIT_CRC_HI;
+			return FRAME_PENDING;
+		case WAIT_CRC_HI: {
+			_frame_crc |= (uint16_t)c << 8;
+			_state = WAIT_SYNC;
+			FrameStatus status = FRAME_OK;
+			if (_frame_crc != _crc) {
+				status = FRAME_BAD_CRC;
+			} else if (_type == FRAME_COLUMNS && _columnsLength() != _length) {
+				status = FRAME_BAD_LENGTH;
+			}
+			// The payload is in the buffer whatever the status, its columns
+			// go out with the next display() all the same
+			_markTouched();
+			return status;
+		}
+	}
+	return FRAME_PENDING;
+}
+
+uint16_t FrameReceiver::ack(FrameStatus status, uint8_t* out) {
+	// Stop and wait, the next frame is decoded into the live buffer
+	const uint8_t payload[2] = { status, 1 };
+	return frameBuild(FRAME_ACK, _seq, payload, sizeof(payload), out);
+}
+
+// Marks every column the payload may have written dirty
+void FrameReceiver::_markTouched(void) {
+	if (_type == FRAME_COLUMNS) {
+		for (uint8_t x = 0; x < _display.width(); x++) {
+			if (_columns[x / 8] & (1 << (x & 7))) _display.markDirty(x, 1);
+		}
+		return;
+	}
+	for (uint8_t i = 0; i < _buffer_width; i++) {
+		if (_touched & ((uint32_t)1 << i)) _display.markDirty(i * 8, 8);
+	}
+}
+
+// Validates the message length and prepares the payload state
+FrameStatus FrameReceiver::_header(void) {
+	switch (_type) {
+		case FRAME_FULL:
+			if (_length != _buffer_size) return FRAME_BAD_LENGTH;
+			break;
+		case FRAME_KEY_RLE:
+			if (_length > FRAME_RLE_MAX(_buffer_size)) return FRAME_BAD_LENGTH;
+			for (uint16_t i = 0; i < _buffer_size; i++) _display.setRowByte(i, 0);
+			break;
+		case FRAME_DELTA:
+			if (_length > FRAME_RLE_MAX(_buffer_size)) return FRAME_BAD_LENGTH;
+			break;
+		case FRAME_COLUMNS:
+			if (_length < _buffer_width || _length > FRAME_COLUMNS_MAX(_display.width(), _display.height())) {
+				return FRAME_BAD_LENGTH;
+			}
+			break;
+		case FRAME_HELLO:
+			if (_length != 0) return FRAME_BAD_LENGTH;
+			break;
+		default:
+			return FRAME_BAD_TYPE;
+	}
+	_received = 0;
+	_pos = 0;
+	_run = 0;
+	_touched = _type == FRAME_KEY_RLE ? 0xFFFFFFFF : 0;
+	return FRAME_OK;
+}
+
+void FrameReceiver::_payload(uint8_t c) {
+	if (_type == FRAME_FULL) {
+		_write(c);
+	} else if (_type == FRAME_COLUMNS) {
+		_column(c);
+		return;
+	} else if (_run) {
+		// Literal bytes of an RLE token
+		if (_pos < _buffer_size) _write(_display.getRowByte(_pos) ^ c);
+		_run--;
+	} else if (c & 0x80) {
+		_run = (c & 0x7F) + 1;
+		return;
+	} else {
+		_pos += c + 1;
+		return;
+	}
+	_pos++;
+}
+
+void FrameReceiver::_write(uint8_t c) {
+	if (_pos >= _buffer_size) return;
+	if (_display.getRowByte(_pos) != c) {
+		_display.setRowByte(_pos, c);
+		_touched |= (uint32_t)1 << (_pos % _buffer_width);
+	}
+}
+
+void FrameReceiver::_column(uint8_t c) {
+	if (_received < _buffer_width) {
+		_columns[_received] = c;
+		if (_received == _buffer_width - 1) _pos = _nextColumn(0);
+		return;
+	}
+	// More column words than bitmap bits, rejected once the CRC is in
+	if (_pos >= _display.width()) return;
+
+	for (uint8_t i = 0; i < 8; i++) {
+		const uint8_t y = _run * 8 + i;
+		if (y >= _display.height()) break;
+		_display.setBufferPixel(_pos, y, c & (1 << i));
+	}
+	if (++_run == _column_size) {
+		_run = 0;
+		_pos = _nextColumn(_pos + 1);
+	}
+}
+
+// First column from x on that is set in the bitmap
+uint16_t FrameReceiver::_nextColumn(uint16_t x) {
+	while (x < _display.width() && !(_columns[x / 8] & (1 << (x & 7)))) x++;
+	return x;
+}
+
+// Payload size the bitmap asks for
+uint16_t FrameReceiver::_columnsLength(void) {
+	uint16_t len = _buffer_width;
+	for (uint8_t x = 0; x < _display.width(); x++) {
+		if (_columns[x / 8] & (1 << (x & 7))) len += _column_size;
+	}
+	return len;
+}
@@ -0,0 +1,59 @@
+#ifndef FRAMERECEIVER_H
+#define FRAMERECEIVER_H
+
+#include <BROSE9323.h>
+#include "FrameProtocol.h"
+
+// Decodes the frame protocol byte by byte straight into the display's
+// _new_buffer, there is no intermediate frame copy. Because of that a
+// frame that fails its CRC has already been applied; after any status
+// other than FRAME_OK the buffer content is undefined until the next key
+// frame. The columns it wrote are marked dirty either way, so the panels
+// never fall behind the buffer.
+class FrameReceiver {
+	private:
+		enum State : uint8_t {
+			WAIT_SYNC,
+			WAIT_TYPE,
+			WAIT_SEQ,
+			WAIT_LEN_LO,
+			WAIT_LEN_HI,
+			WAIT_PAYLOAD,
+			WAIT_CRC_LO,
+			WAIT_CRC_HI
+		};
+
+		BROSE9323& _display;
+		const uint8_t _buffer_width;
+		const uint16_t _buffer_size;
+		const uint8_t _column_size;  // bytes per column word of a COLUMNS message
+		uint8_t* _columns;           // bitmap of a COLUMNS message
+		State _state = WAIT_SYNC;
+		uint8_t _type;
+		uint8_t _seq;
+		uint16_t _length;
+		uint16_t _received;
+		uint16_t _crc;
+		uint16_t _frame_crc;
+		uint16_t _pos;       // buffer offset of the next payload byte, or column of a COLUMNS message
+		uint8_t _run;        // literal bytes left in the current RLE token, or column word byte
+		uint32_t _touched;   // byte columns written, one bit per byte of a row
+
+		FrameStatus _header(void);
+		void _markTouched(void);
+		void _payload(uint8_t);
+		void _write(uint8_t);
+		void _column(uint8_t);
+		uint16_t _nextColumn(uint16_t);
+		uint16_t _columnsLength(void);
+	public:
+		FrameReceiver(BROSE9323&);
+		// Feeds one received byte. Returns FRAME_PENDING until a message is
+		// complete, then its status. type() tells which message it was.
+		FrameStatus feed(uint8_t);
+		uint8_t type(void) { return _type; }
+		// Builds the ACK for a status into out (FRAME_OVERHEAD + 2 bytes),
+		// it answers the message with the last SEQ received
+		uint16_t ack(FrameStatus, uint8_t* out);
+};
+#endif //FRAMERECEIVER_H
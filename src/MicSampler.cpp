@@ -0,0 +1,90 @@
+#include "MicSampler.h"
+
+static MicSampler* _sampler = NULL;
+
+MicSampler::MicSampler(uint16_t threshold, uint16_t holdoff_ms) :
+	_threshold(threshold),
+	_holdoff_ms(holdoff_ms) {
+}
+
+void MicSampler::begin(uint8_t pin) {
+	_pin = pin;
+	_sampler = this;
+	pinMode(pin, INPUT);
+	attachInterrupt(digitalPinToInterrupt(pin), _isr, CHANGE);
+}
+
+void MicSampler::_isr(void) {
+	_sampler->edge(digitalRead(_sampler->_pin), micros());
+}
+
+void MicSampler::edge(bool high, uint32_t now_us) {
+	if (high) {
+		_rise = now_us;
+		_high = true;
+		return;
+	}
+	if (!_high) return;
+	_high = false;
+	const uint32_t width = now_us - _rise;
+	_widths[_head & (MIC_SAMPLER_RING - 1)] = width > 0xFFFF ? 0xFFFF : width;
+	_head++;
+	if (_count < MIC_SAMPLER_RING) {
+		_count++;
+	} else {
+		_dropped++;
+	}
+}
+
+// The level loses an eighth per step, the average follows it by 1/64 per
+// step. After a long gap both start over from silence.
+void MicSampler::_decay(uint32_t now_us) {
+	if (now_us - _step_start >= 64UL * STEP_US) {
+		_level = 0;
+		_average = 0;
+		_step_start = now_us;
+		return;
+	}
+	while (now_us - _step_start >= STEP_US) {
+		_step_start += STEP_US;
+		_level -= _level >> 3;
+		_average = _average - (_average >> 6) + _level;
+	}
+}
+
+void MicSampler::update(uint32_t now_us) {
+	_decay(now_us);
+
+	// The interrupt overwrites the oldest widths once the ring is full, so
+	// read them with it off
+	uint32_t widest = 0;
+	noInterrupts();
+	for (uint8_t i = _head - _count; _count > 0; i++, _count--) {
+		const uint16_t width = _widths[i & (MIC_SAMPLER_RING - 1)];
+		if (width > widest) widest = width;
+	}
+	// A pulse that is still high counts with its width so far
+	if (_high && now_us - _rise > widest) widest = now_us - _rise;
+	interrupts();
+	if (widest > 0xFFFF) widest = 0xFFFF;
+
+	const bool rising = widest > _level;
+	if (rising) _level = widest;
+
+	// An onset is the level rising to over twice its average. The level has
+	// to fall back below that before the next one, so a sound that starts
+	// and stays counts once.
+	if (_level / 2 <= average()) {
+		_armed = true;
+	} else if (rising && _armed && _level >= _threshold && now_us - _last_onset >= _holdoff_ms * 1000UL) {
+		_onset = true;
+		_armed = false;
+		_last_onset = now_us;
+	}
+}
+
+bool MicSampler::onset(void) {
+	const bool onset = _onset;
+	_onset = false;
+	return onset;
+}
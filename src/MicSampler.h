@@ -0,0 +1,65 @@
+#ifndef MICSAMPLER_H
+#define MICSAMPLER_H
+
+#include <Arduino.h>
+
+// Pulse widths kept between two update() calls, a power of two
+#ifndef MIC_SAMPLER_RING
+#define MIC_SAMPLER_RING 16
+#endif
+
+// Measures the microphone module's output pulses from the pin change
+// interrupt instead of waiting for them with pulseIn(). The interrupt
+// timestamps both edges and puts the width of each high pulse into a ring,
+// update() folds them into an envelope that jumps to the widest pulse and
+// decays between pulses. Nothing here blocks, a quiet room just lets the
+// level fall to 0.
+//
+// An onset is a level well above its own slow average, so a beat triggers
+// once instead of every loud sample, and a steady noise triggers only when
+// it starts.
+class MicSampler {
+	private:
+		// Envelope and average advance in steps of this many microseconds
+		static const uint16_t STEP_US = 8000;
+
+		volatile uint16_t _widths[MIC_SAMPLER_RING]; // microseconds high, 0xFFFF at most
+		volatile uint8_t _head = 0;    // next slot the interrupt writes
+		volatile uint8_t _count = 0;   // widths not read by update() yet
+		volatile uint16_t _dropped = 0;
+		volatile bool _high = false;
+		volatile uint32_t _rise;       // micros() of the last rising edge
+		uint8_t _pin;
+
+		uint16_t _level = 0;
+		uint32_t _average = 0;         // of the level, times 64
+		uint32_t _step_start = 0;      // micros() the current step began
+		uint32_t _last_onset = 0;
+		bool _onset = false;
+		bool _armed = true;            // the level was back near its average
+		uint16_t _threshold;
+		uint16_t _holdoff_ms;
+
+		static void _isr(void);
+		void _decay(uint32_t now_us);
+	public:
+		// Onsets need a level of at least threshold microseconds and are at least
+		// holdoff_ms apart
+		MicSampler(uint16_t threshold = 90, uint16_t holdoff_ms = 100);
+		// Attaches the interrupt of pin, which has to be an external interrupt
+		// pin (2 or 3 on the Uno)
+		void begin(uint8_t pin);
+		// Called on every pin change, normally by the interrupt
+		void edge(bool high, uint32_t now_us);
+		// Reads the widths collected since the last call
+		void update(uint32_t now_us);
+
+		// Envelope, in microseconds of pulse width
+		uint16_t level(void) { return _level; }
+		uint16_t average(void) { return _average >> 6; }
+		// True once per onset since the last call
+		bool onset(void);
+		// Widths that arrived while the ring was full, the oldest ones are lost
+		uint16_t dropped(void) { return _dropped; }
+};
+#endif //MICSAMPLER_H
@@ -0,0 +1,81 @@
+#include "SerialCommand.h"
+#include "FrameProtocol.h"
+
+SerialCommand::SerialCommand(Stream& stream) :
+	_stream(stream) {
+}
+
+bool SerialCommand::poll(void) {
+	while (_type == CMD_NONE && _stream.available() > 0) {
+		if (_length == 0 && !_overflow && _stream.peek() == FRAME_SYNC) {
+			_type = CMD_STREAM;
+			break;
+		}
+
+		char c = _stream.read();
+		if (c == '\r' || c == '\n') {
+			// Skips empty lines and the LF of CR LF
+			if (_overflow) {
+				_type = CMD_TOO_LONG;
+				_line[0] = '\0';
+				_argument = _line;
+			} else if (_length > 0) {
+				_parse();
+			}
+			_length = 0;
+			_overflow = false;
+		} else if (_length == 0 && (c == ' ' || c == '\t')) {
+			// Leading whitespace
+		} else if (_length < SERIAL_COMMAND_SIZE) {
+			_line[_length++] = c;
+		} else {
+			// Too long, the line is dropped at its end
+			_overflow = true;
+		}
+	}
+	return ready();
+}
+
+void SerialCommand::clear(void) {
+	_type = CMD_NONE;
+	_argument = NULL;
+}
+
+void SerialCommand::_parse(void) {
+	// Trims trailing whitespace
+	while (_length > 0 && (_line[_length - 1] == ' ' || _line[_length - 1] == '\t')) {
+		_length--;
+	}
+	_line[_length] = '\0';
+	if (_length == 0) return;
+
+	if (_line[0] != '!') {
+		_type = CMD_TEXT;
+		_argument = _line;
+		return;
+	}
+
+	char* argument = strchr(_line, ' ');
+	if (argument) {
+		*argument++ = '\0';
+		while (*argument == ' ') argument++;
+	} else {
+		argument = _line + _length;
+	}
+	_argument = argument;
+
+	if (!strcmp(_line, "!fx")) {
+		_type = CMD_EFFECT;
+	} else if (!strcmp(_line, "!timing")) {
+		_type = CMD_TIMING;
+	} else if (!strcmp(_line, "!flips")) {
+		_type = CMD_FLIPS;
+	} else if (!strcmp(_line, "!stats")) {
+		_type = CMD_STATS;
+	} else if (!strcmp(_line, "!counters")) {
+		_type = CMD_COUNTERS;
+	} else {
+		_type = CMD_UNKNOWN;
+		_argument = _line;
+	}
+}
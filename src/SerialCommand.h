@@ -0,0 +1,60 @@
+#ifndef SERIALCOMMAND_H
+#define SERIALCOMMAND_H
+
+#include <Arduino.h>
+
+#ifndef SERIAL_COMMAND_SIZE
+#define SERIAL_COMMAND_SIZE 100
+#endif
+
+// Commands, one per line (CR and/or LF terminated):
+//
+//   !fx <n>        switch to effect n
+//   !timing <us>   set the flip time
+//   !flips <n>     flip at most n dots per frame, 0 for no limit
+//   !stats         print statistics
+//   !counters      print and reset the display driver counters
+//   anything else  scroll the line as text
+//
+// A line starting with the frame protocol sync byte is not read, it is
+// reported as CMD_STREAM and left in the RX buffer for the frame receiver.
+// A line longer than SERIAL_COMMAND_SIZE is dropped whole and reported as
+// CMD_TOO_LONG, its start would be a different command.
+enum CommandType : uint8_t {
+	CMD_NONE,
+	CMD_TEXT,
+	CMD_EFFECT,
+	CMD_TIMING,
+	CMD_FLIPS,
+	CMD_STATS,
+	CMD_COUNTERS,
+	CMD_STREAM,
+	CMD_TOO_LONG,
+	CMD_UNKNOWN
+};
+
+// Collects serial input into a fixed buffer without blocking and without
+// String allocations. poll() only reads what already is in the RX buffer.
+class SerialCommand {
+	private:
+		Stream& _stream;
+		char _line[SERIAL_COMMAND_SIZE + 1];
+		uint16_t _length = 0;
+		bool _overflow = false;
+		CommandType _type = CMD_NONE;
+		const char* _argument = NULL;
+
+		void _parse(void);
+	public:
+		SerialCommand(Stream&);
+		// Reads pending input, returns true while a complete command waits to
+		// be handled. Further input stays in the RX buffer until clear().
+		bool poll(void);
+		bool ready(void) { return _type != CMD_NONE; }
+		CommandType type(void) { return _type; }
+		// The text of CMD_TEXT, or the parameter of the other commands
+		const char* argument(void) { return _argument; }
+		// Marks the command as handled
+		void clear(void);
+};
+#endif //SERIALCOMMAND_H
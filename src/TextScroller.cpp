@@ -0,0 +1,52 @@
+#include "TextScroller.h"
+
+void TextScroller::Glyph::drawPixel(int16_t x, int16_t y, uint16_t color) {
+	if (color && x >= 0 && x < 6 && y >= 0 && y < 8) columns[x] |= 1 << y;
+}
+
+TextScroller::TextScroller(BROSE9323& display, uint8_t y) :
+	_display(display),
+	_y(y) {
+}
+
+void TextScroller::begin(const char* text) {
+	_text = text;
+	_progmem = false;
+	_column = 6;
+	_trailing = _display.width();
+	_display.fillRect(0, _y, _display.width(), 8, 0);
+}
+
+void TextScroller::begin(const __FlashStringHelper* text) {
+	begin((const char*)text);
+	_progmem = true;
+}
+
+char TextScroller::_nextChar(void) {
+	char c = _progmem ? pgm_read_byte(_text) : *_text;
+	if (c) _text++;
+	return c;
+}
+
+bool TextScroller::step(void) {
+	if (_column == 6) {
+		char c = _text ? _nextChar() : 0;
+		if (c) {
+			memset(_glyph.columns, 0, sizeof(_glyph.columns));
+			_glyph.drawChar(0, 0, c, 1, 0, 1);
+			_column = 0;
+		} else if (_trailing) {
+			// Blank columns until the last glyph is gone
+			_trailing--;
+		} else {
+			return false;
+		}
+	}
+	const uint8_t bits = _column < 6 ? _glyph.columns[_column++] : 0;
+
+	_display.scrollRect(0, _y, _display.width(), 8, -1, 0);
+	for (uint8_t i = 0; i < 8; i++) {
+		_display.drawPixel(_display.width() - 1, _y + i, bits & (1 << i));
+	}
+	return true;
+}
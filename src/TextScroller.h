@@ -0,0 +1,41 @@
+#ifndef TEXTSCROLLER_H
+#define TEXTSCROLLER_H
+
+#include <BROSE9323.h>
+
+// Scrolls a line of text right to left through 8 rows of the display. Each
+// step scrolls those rows one column left and draws only the column that
+// enters on the right, a glyph is rasterised once when it starts to enter.
+// The text is read in place one character at a time, so it can be of any
+// length but has to stay valid until the scroll is done.
+class TextScroller {
+	private:
+		// Captures one glyph of the built-in 5x7 font as 6 column bytes,
+		// bit 0 is the top row
+		class Glyph : public Adafruit_GFX {
+			public:
+				uint8_t columns[6];
+
+				Glyph(void) : Adafruit_GFX(6, 8) {}
+				void drawPixel(int16_t x, int16_t y, uint16_t color);
+		};
+
+		BROSE9323& _display;
+		const uint8_t _y;
+		const char* _text = NULL;
+		bool _progmem = false;
+		uint8_t _column = 6;   // next column of _glyph, 6 when a new glyph is due
+		uint8_t _trailing = 0; // blank columns left after the end of the text
+		Glyph _glyph;
+
+		char _nextChar(void);
+	public:
+		// Text occupies rows [y, y + 8)
+		TextScroller(BROSE9323&, uint8_t y = 4);
+		// Clears the text rows and starts scrolling text in from the right
+		void begin(const char*);
+		void begin(const __FlashStringHelper*);
+		// Scrolls one column. Returns false once the text has left the screen.
+		bool step(void);
+};
+#endif //TEXTSCROLLER_H
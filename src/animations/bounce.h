@@ -0,0 +1,151 @@
+// 84x16, 154 frames, made by flipanim
+const uint8_t bounceAnimation[] PROGMEM = {
+	0x54, 0x10, 0x9a, 0x00, 0x3c, 0x80, 0x0c, 0x00, 0x03, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 
+	0x0e, 0x00, 0x04, 0x7f, 0x3c, 0x80, 0x0c, 0x00, 0x05, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 
+	0x1c, 0x00, 0x08, 0x7f, 0x3c, 0x80, 0x0c, 0x00, 0x07, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 
+	0x38, 0x00, 0x10, 0x7f, 0x3c, 0x80, 0x0c, 0x00, 0x09, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 
+	0x70, 0x00, 0x20, 0x7f, 0x3c, 0x80, 0x0c, 0x00, 0x0b, 0x88, 0x40, 0x00, 0xe0, 0x00, 0xf0, 0x01, 
+	0xe0, 0x00, 0x40, 0x7f, 0x3c, 0x80, 0x0c, 0x00, 0x0d, 0x88, 0x80, 0x00, 0xc0, 0x01, 0xe0, 0x03, 
+	0xc0, 0x01, 0x80, 0x7f, 0x3c, 0x80, 0x0c, 0x00, 0x10, 0x88, 0x01, 0x80, 0x03, 0xc0, 0x07, 0x80, 
+	0x03, 0x00, 0x01, 0x7f, 0x3c, 0x80, 0x0c, 0x00, 0x12, 0x88, 0x02, 0x00, 0x07, 0x80, 0x0f, 0x00, 
+	0x07, 0x00, 0x02, 0x7f, 0x3c, 0x80, 0x0c, 0x00, 0x14, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 
+	0x0e, 0x00, 0x04, 0x7f, 0x3c, 0x80, 0x0c, 0x00, 0x16, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 
+	0x1c, 0x00, 0x08, 0x7f, 0x3c, 0x80, 0x0c, 0x00, 0x18, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 
+	0x38, 0x00, 0x10, 0x7f, 0x3c, 0x80, 0x0c, 0x00, 0x1a, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 
+	0x70, 0x00, 0x20, 0x7f, 0x3c, 0x80, 0x0c, 0x00, 0x1c, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 
+	0x38, 0x00, 0x10, 0x7f, 0x3c, 0x80, 0x0b, 0x00, 0x1e, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 
+	0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 0x20, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 
+	0x00, 0x04, 0x3c, 0x80, 0x0b, 0x00, 0x22, 0x88, 0x02, 0x00, 0x07, 0x80, 0x0f, 0x00, 0x07, 0x00, 
+	0x02, 0x3c, 0x80, 0x0b, 0x00, 0x24, 0x88, 0x01, 0x80, 0x03, 0xc0, 0x07, 0x80, 0x03, 0x00, 0x01, 
+	0x3c, 0x80, 0x0b, 0x00, 0x25, 0x88, 0x80, 0x00, 0xc0, 0x01, 0xe0, 0x03, 0xc0, 0x01, 0x80, 0x3c, 
+	0x80, 0x0b, 0x00, 0x27, 0x88, 0x40, 0x00, 0xe0, 0x00, 0xf0, 0x01, 0xe0, 0x00, 0x40, 0x3c, 0x80, 
+	0x0b, 0x00, 0x29, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 0x00, 0x20, 0x3c, 0x80, 0x0b, 
+	0x00, 0x2b, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x3c, 0x80, 0x0b, 0x00, 
+	0x2d, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 0x2f, 
+	0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 0x00, 0x04, 0x3c, 0x80, 0x0b, 0x00, 0x31, 0x88, 
+	0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 0x33, 0x88, 0x10, 
+	0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x3c, 0x80, 0x0b, 0x00, 0x35, 0x88, 0x20, 0x00, 
+	0x70, 0x00, 0xf8, 0x00, 0x70, 0x00, 0x20, 0x3c, 0x80, 0x0b, 0x00, 0x37, 0x88, 0x40, 0x00, 0xe0, 
+	0x00, 0xf0, 0x01, 0xe0, 0x00, 0x40, 0x3c, 0x80, 0x0b, 0x00, 0x39, 0x88, 0x80, 0x00, 0xc0, 0x01, 
+	0xe0, 0x03, 0xc0, 0x01, 0x80, 0x3c, 0x80, 0x0b, 0x00, 0x3c, 0x88, 0x01, 0x80, 0x03, 0xc0, 0x07, 
+	0x80, 0x03, 0x00, 0x01, 0x3c, 0x80, 0x0b, 0x00, 0x3e, 0x88, 0x02, 0x00, 0x07, 0x80, 0x0f, 0x00, 
+	0x07, 0x00, 0x02, 0x3c, 0x80, 0x0b, 0x00, 0x40, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 
+	0x00, 0x04, 0x3c, 0x80, 0x0b, 0x00, 0x42, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 
+	0x08, 0x3c, 0x80, 0x0b, 0x00, 0x44, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 
+	0x3c, 0x80, 0x0b, 0x00, 0x46, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 0x00, 0x20, 0x3c, 
+	0x80, 0x0b, 0x00, 0x48, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x3c, 0x80, 
+	0x0b, 0x00, 0x4a, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 
+	0x00, 0x4c, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 0x00, 0x04, 0x3c, 0x80, 0x0b, 0x00, 
+	0x4e, 0x88, 0x02, 0x00, 0x07, 0x80, 0x0f, 0x00, 0x07, 0x00, 0x02, 0x3c, 0x80, 0x0b, 0x00, 0x50, 
+	0x88, 0x01, 0x80, 0x03, 0xc0, 0x07, 0x80, 0x03, 0x00, 0x01, 0x3c, 0x80, 0x0b, 0x00, 0x51, 0x88, 
+	0x80, 0x00, 0xc0, 0x01, 0xe0, 0x03, 0xc0, 0x01, 0x80, 0x3c, 0x80, 0x0b, 0x00, 0x53, 0x88, 0x40, 
+	0x00, 0xe0, 0x00, 0xf0, 0x01, 0xe0, 0x00, 0x40, 0x3c, 0x80, 0x0b, 0x00, 0x55, 0x88, 0x20, 0x00, 
+	0x70, 0x00, 0xf8, 0x00, 0x70, 0x00, 0x20, 0x3c, 0x80, 0x0b, 0x00, 0x57, 0x88, 0x10, 0x00, 0x38, 
+	0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x3c, 0x80, 0x0b, 0x00, 0x59, 0x88, 0x08, 0x00, 0x1c, 0x00, 
+	0x3e, 0x00, 0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 0x5b, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 
+	0x00, 0x0e, 0x00, 0x04, 0x3c, 0x80, 0x0b, 0x00, 0x5d, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 
+	0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 0x5f, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 
+	0x00, 0x10, 0x3c, 0x80, 0x0b, 0x00, 0x61, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 0x00, 
+	0x20, 0x3c, 0x80, 0x0b, 0x00, 0x63, 0x88, 0x40, 0x00, 0xe0, 0x00, 0xf0, 0x01, 0xe0, 0x00, 0x40, 
+	0x3c, 0x80, 0x0b, 0x00, 0x65, 0x88, 0x80, 0x00, 0xc0, 0x01, 0xe0, 0x03, 0xc0, 0x01, 0x80, 0x3c, 
+	0x80, 0x0b, 0x00, 0x68, 0x88, 0x01, 0x80, 0x03, 0xc0, 0x07, 0x80, 0x03, 0x00, 0x01, 0x3c, 0x80, 
+	0x0b, 0x00, 0x6a, 0x88, 0x02, 0x00, 0x07, 0x80, 0x0f, 0x00, 0x07, 0x00, 0x02, 0x3c, 0x80, 0x0b, 
+	0x00, 0x6c, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 0x00, 0x04, 0x3c, 0x80, 0x0b, 0x00, 
+	0x6e, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 0x70, 
+	0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x3c, 0x80, 0x0b, 0x00, 0x72, 0x88, 
+	0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 0x00, 0x20, 0x3c, 0x80, 0x0b, 0x00, 0x74, 0x88, 0x10, 
+	0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x3c, 0x80, 0x0b, 0x00, 0x76, 0x88, 0x08, 0x00, 
+	0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 0x78, 0x88, 0x04, 0x00, 0x0e, 
+	0x00, 0x1f, 0x00, 0x0e, 0x00, 0x04, 0x3c, 0x80, 0x0b, 0x00, 0x7a, 0x88, 0x02, 0x00, 0x07, 0x80, 
+	0x0f, 0x00, 0x07, 0x00, 0x02, 0x3c, 0x80, 0x0b, 0x00, 0x7c, 0x88, 0x01, 0x80, 0x03, 0xc0, 0x07, 
+	0x80, 0x03, 0x00, 0x01, 0x3c, 0x80, 0x0b, 0x00, 0x7d, 0x88, 0x80, 0x00, 0xc0, 0x01, 0xe0, 0x03, 
+	0xc0, 0x01, 0x80, 0x3c, 0x80, 0x0b, 0x00, 0x7f, 0x88, 0x40, 0x00, 0xe0, 0x00, 0xf0, 0x01, 0xe0, 
+	0x00, 0x40, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x01, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 
+	0x00, 0x20, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x03, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 
+	0x00, 0x10, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x05, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 
+	0x00, 0x08, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x07, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 
+	0x00, 0x04, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x09, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 
+	0x00, 0x08, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x0b, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 
+	0x00, 0x10, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x0d, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 
+	0x00, 0x20, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x0f, 0x88, 0x40, 0x00, 0xe0, 0x00, 0xf0, 0x01, 0xe0, 
+	0x00, 0x40, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x11, 0x88, 0x80, 0x00, 0xc0, 0x01, 0xe0, 0x03, 0xc0, 
+	0x01, 0x80, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x14, 0x88, 0x01, 0x80, 0x03, 0xc0, 0x07, 0x80, 0x03, 
+	0x00, 0x01, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x16, 0x88, 0x02, 0x00, 0x07, 0x80, 0x0f, 0x00, 0x07, 
+	0x00, 0x02, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x18, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 
+	0x00, 0x04, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x1a, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 
+	0x00, 0x08, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x1c, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 
+	0x00, 0x10, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x1e, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 
+	0x00, 0x20, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x1c, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 
+	0x00, 0x10, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x1a, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 
+	0x00, 0x08, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x18, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 
+	0x00, 0x04, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x16, 0x88, 0x02, 0x00, 0x07, 0x80, 0x0f, 0x00, 0x07, 
+	0x00, 0x02, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x14, 0x88, 0x01, 0x80, 0x03, 0xc0, 0x07, 0x80, 0x03, 
+	0x00, 0x01, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x11, 0x88, 0x80, 0x00, 0xc0, 0x01, 0xe0, 0x03, 0xc0, 
+	0x01, 0x80, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x0f, 0x88, 0x40, 0x00, 0xe0, 0x00, 0xf0, 0x01, 0xe0, 
+	0x00, 0x40, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x0d, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 
+	0x00, 0x20, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x0b, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 
+	0x00, 0x10, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x09, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 
+	0x00, 0x08, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x07, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 
+	0x00, 0x04, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x05, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 
+	0x00, 0x08, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x03, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 
+	0x00, 0x10, 0x3c, 0x80, 0x0c, 0x00, 0x7f, 0x01, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 
+	0x00, 0x20, 0x3c, 0x80, 0x0b, 0x00, 0x7f, 0x88, 0x40, 0x00, 0xe0, 0x00, 0xf0, 0x01, 0xe0, 0x00, 
+	0x40, 0x3c, 0x80, 0x0b, 0x00, 0x7d, 0x88, 0x80, 0x00, 0xc0, 0x01, 0xe0, 0x03, 0xc0, 0x01, 0x80, 
+	0x3c, 0x80, 0x0b, 0x00, 0x7c, 0x88, 0x01, 0x80, 0x03, 0xc0, 0x07, 0x80, 0x03, 0x00, 0x01, 0x3c, 
+	0x80, 0x0b, 0x00, 0x7a, 0x88, 0x02, 0x00, 0x07, 0x80, 0x0f, 0x00, 0x07, 0x00, 0x02, 0x3c, 0x80, 
+	0x0b, 0x00, 0x78, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 0x00, 0x04, 0x3c, 0x80, 0x0b, 
+	0x00, 0x76, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 
+	0x74, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x3c, 0x80, 0x0b, 0x00, 0x72, 
+	0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 0x00, 0x20, 0x3c, 0x80, 0x0b, 0x00, 0x70, 0x88, 
+	0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x3c, 0x80, 0x0b, 0x00, 0x6e, 0x88, 0x08, 
+	0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 0x6c, 0x88, 0x04, 0x00, 
+	0x0e, 0x00, 0x1f, 0x00, 0x0e, 0x00, 0x04, 0x3c, 0x80, 0x0b, 0x00, 0x6a, 0x88, 0x02, 0x00, 0x07, 
+	0x80, 0x0f, 0x00, 0x07, 0x00, 0x02, 0x3c, 0x80, 0x0b, 0x00, 0x68, 0x88, 0x01, 0x80, 0x03, 0xc0, 
+	0x07, 0x80, 0x03, 0x00, 0x01, 0x3c, 0x80, 0x0b, 0x00, 0x65, 0x88, 0x80, 0x00, 0xc0, 0x01, 0xe0, 
+	0x03, 0xc0, 0x01, 0x80, 0x3c, 0x80, 0x0b, 0x00, 0x63, 0x88, 0x40, 0x00, 0xe0, 0x00, 0xf0, 0x01, 
+	0xe0, 0x00, 0x40, 0x3c, 0x80, 0x0b, 0x00, 0x61, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 
+	0x00, 0x20, 0x3c, 0x80, 0x0b, 0x00, 0x5f, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 
+	0x10, 0x3c, 0x80, 0x0b, 0x00, 0x5d, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 
+	0x3c, 0x80, 0x0b, 0x00, 0x5b, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 0x00, 0x04, 0x3c, 
+	0x80, 0x0b, 0x00, 0x59, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x3c, 0x80, 
+	0x0b, 0x00, 0x57, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x3c, 0x80, 0x0b, 
+	0x00, 0x55, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 0x00, 0x20, 0x3c, 0x80, 0x0b, 0x00, 
+	0x53, 0x88, 0x40, 0x00, 0xe0, 0x00, 0xf0, 0x01, 0xe0, 0x00, 0x40, 0x3c, 0x80, 0x0b, 0x00, 0x51, 
+	0x88, 0x80, 0x00, 0xc0, 0x01, 0xe0, 0x03, 0xc0, 0x01, 0x80, 0x3c, 0x80, 0x0b, 0x00, 0x50, 0x88, 
+	0x01, 0x80, 0x03, 0xc0, 0x07, 0x80, 0x03, 0x00, 0x01, 0x3c, 0x80, 0x0b, 0x00, 0x4e, 0x88, 0x02, 
+	0x00, 0x07, 0x80, 0x0f, 0x00, 0x07, 0x00, 0x02, 0x3c, 0x80, 0x0b, 0x00, 0x4c, 0x88, 0x04, 0x00, 
+	0x0e, 0x00, 0x1f, 0x00, 0x0e, 0x00, 0x04, 0x3c, 0x80, 0x0b, 0x00, 0x4a, 0x88, 0x08, 0x00, 0x1c, 
+	0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 0x48, 0x88, 0x10, 0x00, 0x38, 0x00, 
+	0x7c, 0x00, 0x38, 0x00, 0x10, 0x3c, 0x80, 0x0b, 0x00, 0x46, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 
+	0x00, 0x70, 0x00, 0x20, 0x3c, 0x80, 0x0b, 0x00, 0x44, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 
+	0x38, 0x00, 0x10, 0x3c, 0x80, 0x0b, 0x00, 0x42, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 
+	0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 0x40, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 0x00, 
+	0x04, 0x3c, 0x80, 0x0b, 0x00, 0x3e, 0x88, 0x02, 0x00, 0x07, 0x80, 0x0f, 0x00, 0x07, 0x00, 0x02, 
+	0x3c, 0x80, 0x0b, 0x00, 0x3c, 0x88, 0x01, 0x80, 0x03, 0xc0, 0x07, 0x80, 0x03, 0x00, 0x01, 0x3c, 
+	0x80, 0x0b, 0x00, 0x39, 0x88, 0x80, 0x00, 0xc0, 0x01, 0xe0, 0x03, 0xc0, 0x01, 0x80, 0x3c, 0x80, 
+	0x0b, 0x00, 0x37, 0x88, 0x40, 0x00, 0xe0, 0x00, 0xf0, 0x01, 0xe0, 0x00, 0x40, 0x3c, 0x80, 0x0b, 
+	0x00, 0x35, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 0x00, 0x20, 0x3c, 0x80, 0x0b, 0x00, 
+	0x33, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x3c, 0x80, 0x0b, 0x00, 0x31, 
+	0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 0x2f, 0x88, 
+	0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 0x00, 0x04, 0x3c, 0x80, 0x0b, 0x00, 0x2d, 0x88, 0x08, 
+	0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x3c, 0x80, 0x0b, 0x00, 0x2b, 0x88, 0x10, 0x00, 
+	0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x3c, 0x80, 0x0b, 0x00, 0x29, 0x88, 0x20, 0x00, 0x70, 
+	0x00, 0xf8, 0x00, 0x70, 0x00, 0x20, 0x3c, 0x80, 0x0b, 0x00, 0x27, 0x88, 0x40, 0x00, 0xe0, 0x00, 
+	0xf0, 0x01, 0xe0, 0x00, 0x40, 0x3c, 0x80, 0x0b, 0x00, 0x25, 0x88, 0x80, 0x00, 0xc0, 0x01, 0xe0, 
+	0x03, 0xc0, 0x01, 0x80, 0x3c, 0x80, 0x0b, 0x00, 0x24, 0x88, 0x01, 0x80, 0x03, 0xc0, 0x07, 0x80, 
+	0x03, 0x00, 0x01, 0x3c, 0x80, 0x0b, 0x00, 0x22, 0x88, 0x02, 0x00, 0x07, 0x80, 0x0f, 0x00, 0x07, 
+	0x00, 0x02, 0x3c, 0x80, 0x0b, 0x00, 0x20, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 0x00, 
+	0x04, 0x3c, 0x80, 0x0b, 0x00, 0x1e, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 
+	0x3c, 0x80, 0x0c, 0x00, 0x1c, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x7f, 
+	0x3c, 0x80, 0x0c, 0x00, 0x1a, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 0x00, 0x20, 0x7f, 
+	0x3c, 0x80, 0x0c, 0x00, 0x18, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x7f, 
+	0x3c, 0x80, 0x0c, 0x00, 0x16, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x7f, 
+	0x3c, 0x80, 0x0c, 0x00, 0x14, 0x88, 0x04, 0x00, 0x0e, 0x00, 0x1f, 0x00, 0x0e, 0x00, 0x04, 0x7f, 
+	0x3c, 0x80, 0x0c, 0x00, 0x12, 0x88, 0x02, 0x00, 0x07, 0x80, 0x0f, 0x00, 0x07, 0x00, 0x02, 0x7f, 
+	0x3c, 0x80, 0x0c, 0x00, 0x10, 0x88, 0x01, 0x80, 0x03, 0xc0, 0x07, 0x80, 0x03, 0x00, 0x01, 0x7f, 
+	0x3c, 0x80, 0x0c, 0x00, 0x0d, 0x88, 0x80, 0x00, 0xc0, 0x01, 0xe0, 0x03, 0xc0, 0x01, 0x80, 0x7f, 
+	0x3c, 0x80, 0x0c, 0x00, 0x0b, 0x88, 0x40, 0x00, 0xe0, 0x00, 0xf0, 0x01, 0xe0, 0x00, 0x40, 0x7f, 
+	0x3c, 0x80, 0x0c, 0x00, 0x09, 0x88, 0x20, 0x00, 0x70, 0x00, 0xf8, 0x00, 0x70, 0x00, 0x20, 0x7f, 
+	0x3c, 0x80, 0x0c, 0x00, 0x07, 0x88, 0x10, 0x00, 0x38, 0x00, 0x7c, 0x00, 0x38, 0x00, 0x10, 0x7f, 
+	0x3c, 0x80, 0x0c, 0x00, 0x05, 0x88, 0x08, 0x00, 0x1c, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x7f
+};
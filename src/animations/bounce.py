@@ -0,0 +1,30 @@
+#!/usr/bin/env python3
+# Frames of the bounce animation (bounce.h): a ball bouncing off the edges
+# of the 84x16 display, 154 frames until it is back where it started.
+#
+#   python3 bounce.py frames/
+#   flipanim -n bounceAnimation -t 60 -o bounce.h frames/*.pbm
+
+import os
+import sys
+
+WIDTH, HEIGHT = 84, 16
+RADIUS = 2
+
+out = sys.argv[1] if len(sys.argv) > 1 else "."
+os.makedirs(out, exist_ok=True)
+
+# x runs 4..81 and y 2..13, 154 and 22 frames there and back
+x, y, dx, dy = 4, 2, 1, 1
+for n in range(154):
+    with open(os.path.join(out, "%03d.pbm" % n), "w") as f:
+        f.write("P1\n%d %d\n" % (WIDTH, HEIGHT))
+        for row in range(HEIGHT):
+            f.write(" ".join("1" if (col - x) ** 2 + (row - y) ** 2 <= RADIUS ** 2 else "0"
+                             for col in range(WIDTH)) + "\n")
+    if not 4 <= x + dx <= 81:
+        dx = -dx
+    if not 2 <= y + dy <= 13:
+        dy = -dy
+    x += dx
+    y += dy
@@ -0,0 +1,49 @@
+#ifndef ANIMATIONENCODER_H
+#define ANIMATIONENCODER_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "../Animation.h"
+#include "../FrameProtocol.h"
+
+// Encodes frames into the animation format of src/Animation.h. A frame is
+// its column words, width * ((height + 7) / 8) bytes. Each frame is stored
+// as the XOR against the frame before or as a key frame, whichever is
+// smaller; key_interval forces a key frame every that many frames, the
+// first frame is always one. keys, if given, receives the number of key
+// frames.
+inline std::vector<uint8_t> animationEncode(uint8_t width, uint8_t height,
+		const std::vector<std::vector<uint8_t> >& frames, const std::vector<uint16_t>& durations,
+		int key_interval = 0, int* keys = NULL) {
+	std::vector<uint8_t> animation;
+	animation.push_back(width);
+	animation.push_back(height);
+	animation.push_back(frames.size() & 0xFF);
+	animation.push_back(frames.size() >> 8);
+
+	const uint16_t frame_size = width * ((height + 7) / 8);
+	std::vector<uint8_t> key(FRAME_RLE_MAX(frame_size));
+	std::vector<uint8_t> delta(FRAME_RLE_MAX(frame_size));
+	if (keys) *keys = 0;
+	for (size_t n = 0; n < frames.size(); n++) {
+		const uint16_t key_len = frameEncodeRLE(NULL, frames[n].data(), frame_size, key.data(), key.size());
+		uint16_t delta_len = FRAME_RLE_OVERFLOW;
+		if (n > 0 && !(key_interval && n % key_interval == 0)) {
+			delta_len = frameEncodeRLE(frames[n - 1].data(), frames[n].data(), frame_size, delta.data(), delta.size());
+		}
+		const bool is_key = delta_len == FRAME_RLE_OVERFLOW || key_len < delta_len;
+		const std::vector<uint8_t>& payload = is_key ? key : delta;
+		const uint16_t len = is_key ? key_len : delta_len;
+		const uint16_t ms = durations[n] | (is_key ? ANIMATION_KEY : 0);
+
+		animation.push_back(ms & 0xFF);
+		animation.push_back(ms >> 8);
+		animation.push_back(len & 0xFF);
+		animation.push_back(len >> 8);
+		animation.insert(animation.end(), payload.begin(), payload.begin() + len);
+		if (keys && is_key) (*keys)++;
+	}
+	return animation;
+}
+#endif //ANIMATIONENCODER_H
@@ -0,0 +1,81 @@
+#ifndef HOSTCANVAS_H
+#define HOSTCANVAS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// Frame buffer for the host renderer with the drawing calls the portable
+// effects use. The layout is the row-major one of the frame protocol: rows
+// of (width + 7) / 8 bytes, bit 0 of a byte is its leftmost pixel.
+class HostCanvas {
+	private:
+		const int16_t _width;
+		const int16_t _height;
+		const uint16_t _buffer_width;
+		std::vector<uint8_t> _buffer;
+	public:
+		HostCanvas(int16_t w, int16_t h) :
+			_width(w), _height(h), _buffer_width((w + 7) / 8), _buffer(_buffer_width * h) {}
+
+		int16_t width(void) const { return _width; }
+		int16_t height(void) const { return _height; }
+		const uint8_t* buffer(void) const { return _buffer.data(); }
+		uint16_t bufferSize(void) const { return _buffer.size(); }
+
+		void drawPixel(int16_t x, int16_t y, uint16_t color) {
+			if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+			if (color) {
+				_buffer[y * _buffer_width + x / 8] |= 1 << (x & 7);
+			} else {
+				_buffer[y * _buffer_width + x / 8] &= ~(1 << (x & 7));
+			}
+		}
+
+		// Rows 8 * i to 8 * i + 7 of column x, bit 0 for the topmost, as the
+		// display has them for the animation player
+		uint8_t getColumnByte(uint8_t x, uint8_t i) const {
+			uint8_t bits = 0;
+			for (uint8_t b = 0; b < 8 && 8 * i + b < _height; b++) {
+				if (_buffer[(8 * i + b) * _buffer_width + x / 8] & (1 << (x & 7))) bits |= 1 << b;
+			}
+			return bits;
+		}
+
+		void setColumnByte(uint8_t x, uint8_t i, uint8_t bits) {
+			for (uint8_t b = 0; b < 8 && 8 * i + b < _height; b++) {
+				drawPixel(x, 8 * i + b, bits & (1 << b));
+			}
+		}
+
+		// The whole buffer is sent anyway
+		void markDirty(int16_t, int16_t) {}
+
+		void fillScreen(uint16_t color) {
+			memset(_buffer.data(), color ? 0xFF : 0x00, _buffer.size());
+		}
+
+		void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+			for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+		}
+
+		void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+			for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+		}
+
+		// Moves the image by dx columns right and dy rows down, the uncovered
+		// dots get fill
+		void scroll(int16_t dx, int16_t dy, uint16_t fill = 0) {
+			std::vector<uint8_t> from(_buffer);
+			fillScreen(fill);
+			for (int16_t y = 0; y < _height; y++) {
+				for (int16_t x = 0; x < _width; x++) {
+					const int16_t sx = x - dx;
+					const int16_t sy = y - dy;
+					if (sx < 0 || sy < 0 || sx >= _width || sy >= _height) continue;
+					drawPixel(x, y, from[sy * _buffer_width + sx / 8] & (1 << (sx & 7)));
+				}
+			}
+		}
+};
+#endif //HOSTCANVAS_H
@@ -0,0 +1,203 @@
+// Animation encoder: turns a sequence of PBM images into the animation
+// format of src/Animation.h and writes it as a C header for the
+// controller's flash.
+//
+//   flipanim [-n name] [-t ms] [-k interval] [-i] [-o file.h] frame.pbm[@ms]...
+//
+// Every image is one frame and has to have the size of the first one. A
+// frame stays for the milliseconds after its file name, or -t (100). By
+// default a black pixel is a set dot, -i inverts that. Each frame is stored
+// as the XOR against the frame before or as a key frame, whichever is
+// smaller; -k forces a key frame every interval frames, the first frame is
+// always one.
+//
+// Build with the PlatformIO "flipanim" environment: pio run -e flipanim
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "AnimationEncoder.h"
+#include "HostCanvas.h"
+
+struct Image {
+	int width;
+	int height;
+	std::vector<uint8_t> buffer;  // row-major, as HostCanvas keeps it
+};
+
+static int pbmNumber(FILE* f) {
+	int c = fgetc(f);
+	while (c == '#' || c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+		if (c == '#') {
+			while (c != '\n' && c != EOF) c = fgetc(f);
+		}
+		c = fgetc(f);
+	}
+	int n = -1;
+	while (c >= '0' && c <= '9') {
+		n = (n < 0 ? 0 : n * 10) + c - '0';
+		c = fgetc(f);
+	}
+	return n;
+}
+
+// Reads a plain (P1) or raw (P4) PBM file, 1 is black
+static bool readPbm(const char* path, bool invert, Image& image) {
+	FILE* f = fopen(path, "rb");
+	if (!f) {
+		perror(path);
+		return false;
+	}
+	char magic[2];
+	const bool raw = fread(magic, 1, 2, f) == 2 && magic[0] == 'P' && magic[1] == '4';
+	if (!raw && (magic[0] != 'P' || magic[1] != '1')) {
+		fprintf(stderr, "%s: not a PBM file\n", path);
+		fclose(f);
+		return false;
+	}
+	image.width = pbmNumber(f);
+	image.height = pbmNumber(f);
+	if (image.width < 1 || image.width > 255 || image.height < 1 || image.height > 255) {
+		fprintf(stderr, "%s: size out of range\n", path);
+		fclose(f);
+		return false;
+	}
+
+	HostCanvas canvas(image.width, image.height);
+	const int row_bytes = (image.width + 7) / 8;
+	std::vector<uint8_t> row(row_bytes);
+	for (int y = 0; y < image.height; y++) {
+		if (raw && fread(row.data(), 1, row_bytes, f) != (size_t)row_bytes) {
+			fprintf(stderr, "%s: truncated\n", path);
+			fclose(f);
+			return false;
+		}
+		for (int x = 0; x < image.width; x++) {
+			int black;
+			if (raw) {
+				black = (row[x / 8] >> (7 - (x & 7))) & 1;
+			} else {
+				int c;
+				do {
+					c = fgetc(f);
+				} while (c != '0' && c != '1' && c != EOF);
+				if (c == EOF) {
+					fprintf(stderr, "%s: truncated\n", path);
+					fclose(f);
+					return false;
+				}
+				black = c == '1';
+			}
+			canvas.drawPixel(x, y, black != invert);
+		}
+	}
+	fclose(f);
+	image.buffer.assign(canvas.buffer(), canvas.buffer() + canvas.bufferSize());
+	return true;
+}
+
+// A frame as the sequence of column words the animation format encodes
+static std::vector<uint8_t> columnWords(const Image& image) {
+	const int row_bytes = (image.width + 7) / 8;
+	const uint8_t column_size = (image.height + 7) / 8;
+	std::vector<uint8_t> words(image.width * column_size);
+	for (int y = 0; y < image.height; y++) {
+		for (int x = 0; x < image.width; x++) {
+			if (image.buffer[y * row_bytes + x / 8] & (1 << (x & 7))) {
+				words[x * column_size + y / 8] |= 1 << (y & 7);
+			}
+		}
+	}
+	return words;
+}
+
+static void usage(void) {
+	fprintf(stderr, "usage: flipanim [-n name] [-t ms] [-k interval] [-i] [-o file.h] frame.pbm[@ms]...\n");
+	exit(2);
+}
+
+int main(int argc, char** argv) {
+	const char* name = "animation";
+	const char* output = NULL;
+	int default_ms = 100;
+	int key_interval = 0;
+	bool invert = false;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "n:t:k:io:")) != -1) {
+		switch (opt) {
+			case 'n':
+				name = optarg;
+				break;
+			case 't':
+				default_ms = atoi(optarg);
+				break;
+			case 'k':
+				key_interval = atoi(optarg);
+				break;
+			case 'i':
+				invert = true;
+				break;
+			case 'o':
+				output = optarg;
+				break;
+			default:
+				usage();
+		}
+	}
+	const int count = argc - optind;
+	if (count < 1 || count > 0xFFFF || key_interval < 0) usage();
+
+	std::vector<Image> images(count);
+	std::vector<uint16_t> durations(count);
+	for (int n = 0; n < count; n++) {
+		std::string path = argv[optind + n];
+		int ms = default_ms;
+		const size_t at = path.rfind('@');
+		if (at != std::string::npos) {
+			ms = atoi(path.c_str() + at + 1);
+			path.resize(at);
+		}
+		if (ms < 1 || ms >= ANIMATION_KEY) {
+			fprintf(stderr, "%s: duration out of range\n", argv[optind + n]);
+			return 2;
+		}
+		durations[n] = ms;
+		if (!readPbm(path.c_str(), invert, images[n])) return 1;
+		if (images[n].width != images[0].width || images[n].height != images[0].height) {
+			fprintf(stderr, "%s: %dx%d, the first frame is %dx%d\n", path.c_str(),
+				images[n].width, images[n].height, images[0].width, images[0].height);
+			return 1;
+		}
+	}
+	const int width = images[0].width;
+	const int height = images[0].height;
+
+	std::vector<std::vector<uint8_t> > frames(count);
+	for (int n = 0; n < count; n++) frames[n] = columnWords(images[n]);
+	int keys;
+	const std::vector<uint8_t> animation = animationEncode(width, height, frames, durations, key_interval, &keys);
+
+	FILE* out = output ? fopen(output, "w") : stdout;
+	if (!out) {
+		perror(output);
+		return 1;
+	}
+	fprintf(out, "// %dx%d, %d frames, made by flipanim\n", width, height, count);
+	fprintf(out, "const uint8_t %s[] PROGMEM = {", name);
+	for (size_t i = 0; i < animation.size(); i++) {
+		fprintf(out, "%s0x%02x%s", i % 16 ? "" : "\n\t", animation[i], i + 1 < animation.size() ? ", " : "");
+	}
+	fprintf(out, "\n};\n");
+	if (output) fclose(out);
+
+	const size_t raw = (size_t)count * frames[0].size();
+	fprintf(stderr, "%d frames (%d key), %zu bytes raw, %zu bytes encoded, ratio %.1f:1\n",
+		count, keys, raw, animation.size(), (double)raw / animation.size());
+	return 0;
+}
@@ -0,0 +1,298 @@
+// Host render daemon: runs the portable effects (src/Effects.h) on a Linux
+// host such as a Raspberry Pi and streams the result to the controller as
+// COLUMNS messages of the frame protocol (src/FrameProtocol.h).
+//
+//   fliprender [-s 84x16] [-d seconds] [-e effect] [-v] /dev/ttyUSB0
+//
+// Frames are rendered on time whatever the link does. Only one message is
+// in flight: until the controller acknowledges it, which it does once the
+// dots are flipped, newer frames replace each other and the next message
+// carries everything that changed since the last acknowledged frame. A
+// failed or missing ACK makes the next message resend all columns, an ACK
+// for an earlier message that comes in late is ignored.
+//
+// Build with the PlatformIO "native" environment: pio run -e native
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "../Effects.h"
+#include "../FrameProtocol.h"
+#include "HostCanvas.h"
+
+// Without an ACK for this long the controller's buffer is unknown
+static const uint32_t ACK_TIMEOUT_MS = 2000;
+// The controller leaves streaming mode after 2 s without a message
+static const uint32_t KEEPALIVE_MS = 1000;
+
+static volatile sig_atomic_t stopping = 0;
+
+static void onSignal(int) {
+	stopping = 1;
+}
+
+static uint32_t millis(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000UL + ts.tv_nsec / 1000000UL;
+}
+
+static int openSerial(const char* path) {
+	const int fd = open(path, O_RDWR | O_NOCTTY);
+	if (fd < 0) return -1;
+
+	struct termios tio;
+	if (tcgetattr(fd, &tio) == 0) {
+		cfmakeraw(&tio);
+		cfsetispeed(&tio, B115200);
+		cfsetospeed(&tio, B115200);
+		tio.c_cflag |= CLOCAL | CREAD;
+		tio.c_cc[VMIN] = 0;
+		tio.c_cc[VTIME] = 0;
+		tcsetattr(fd, TCSANOW, &tio);
+	}
+	return fd;
+}
+
+static bool writeAll(int fd, const uint8_t* data, size_t len) {
+	while (len > 0) {
+		const ssize_t n = write(fd, data, len);
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			return false;
+		}
+		data += n;
+		len -= n;
+	}
+	return true;
+}
+
+// Picks the controller's ACK messages out of whatever else it prints
+class AckParser {
+	private:
+		std::vector<uint8_t> _message;
+		uint8_t _seq = 0;
+	public:
+		// Returns the status of a complete, intact ACK, FRAME_PENDING otherwise
+		FrameStatus feed(uint8_t c) {
+			if (_message.empty() && c != FRAME_SYNC) return FRAME_PENDING;
+			_message.push_back(c);
+			if (_message.size() < FRAME_HEADER_SIZE) return FRAME_PENDING;
+
+			const uint16_t len = _message[3] | _message[4] << 8;
+			if (_message[1] != FRAME_ACK || len != 2) {
+				_message.clear();
+				return FRAME_PENDING;
+			}
+			if (_message.size() < (size_t)(FRAME_OVERHEAD + len)) return FRAME_PENDING;
+
+			uint16_t crc = 0xFFFF;
+			for (uint16_t i = 1; i < FRAME_HEADER_SIZE + len; i++) {
+				crc = frameCrc16(crc, _message[i]);
+			}
+			const bool intact = crc == (_message[FRAME_HEADER_SIZE + len] | _message[FRAME_HEADER_SIZE + len + 1] << 8);
+			const FrameStatus status = (FrameStatus)_message[FRAME_HEADER_SIZE];
+			if (intact) _seq = _message[2];
+			_message.clear();
+			return intact ? status : FRAME_BAD_CRC;
+		}
+		// SEQ of the message the last intact ACK answers
+		uint8_t seq(void) { return _seq; }
+};
+
+struct Stats {
+	uint32_t rendered = 0;
+	uint32_t overruns = 0;   // frames rendered late
+	uint32_t messages = 0;
+	uint32_t bytes = 0;
+	uint32_t resyncs = 0;    // bad or missing ACKs
+	uint32_t ack_ms = 0;     // summed round trips
+};
+
+static void printStats(const Stats& s) {
+	fprintf(stderr, "rendered=%u overruns=%u messages=%u bytes=%u resyncs=%u ack_ms_avg=%u\n",
+		s.rendered, s.overruns, s.messages, s.bytes, s.resyncs, s.messages ? s.ack_ms / s.messages : 0);
+}
+
+static void usage(void) {
+	fprintf(stderr, "usage: fliprender [-s WIDTHxHEIGHT] [-d seconds] [-e effect] [-v] device\n");
+	exit(2);
+}
+
+int main(int argc, char** argv) {
+	int width = 84;
+	int height = 16;
+	uint32_t duration_ms = 10000;
+	const char* only = NULL;
+	bool verbose = false;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "s:d:e:v")) != -1) {
+		switch (opt) {
+			case 's':
+				if (sscanf(optarg, "%dx%d", &width, &height) != 2) usage();
+				break;
+			case 'd':
+				duration_ms = atoi(optarg) * 1000UL;
+				break;
+			case 'e':
+				only = optarg;
+				break;
+			case 'v':
+				verbose = true;
+				break;
+			default:
+				usage();
+		}
+	}
+	if (optind != argc - 1 || width < 1 || width > 255 || height < 1 || height > 255) usage();
+
+	HostCanvas canvas(width, height);
+	MatrixEffect<HostCanvas, 127> matrix(canvas);
+	RandomFlipEffect<HostCanvas> randomFlip(canvas);
+	SweepEffect<HostCanvas> sweep(canvas);
+	RandomFlickerEffect<HostCanvas> randomFlicker(canvas);
+	LinesEffect<HostCanvas> lines(canvas);
+	Effect* const effects[] = { &matrix, &randomFlip, &sweep, &randomFlicker, &lines };
+	const uint8_t count = sizeof(effects) / sizeof(effects[0]);
+
+	uint8_t current = 0;
+	if (only) {
+		while (current < count && strcmp(effects[current]->name(), only)) current++;
+		if (current == count) {
+			fprintf(stderr, "unknown effect %s, one of:", only);
+			for (uint8_t i = 0; i < count; i++) fprintf(stderr, " %s", effects[i]->name());
+			fprintf(stderr, "\n");
+			return 2;
+		}
+	}
+
+	const int fd = openSerial(argv[optind]);
+	if (fd < 0) {
+		perror(argv[optind]);
+		return 1;
+	}
+	signal(SIGINT, onSignal);
+	signal(SIGTERM, onSignal);
+
+	// Opening the port resets an Uno, give the bootloader time to finish.
+	// A newline ends any partial command so the SYNC starts a line.
+	sleep(2);
+	tcflush(fd, TCIFLUSH);
+	const uint8_t newline = '\n';
+	writeAll(fd, &newline, 1);
+
+	EffectRandom::seed(time(NULL));
+	const uint16_t bitmap_size = (width + 7) / 8;
+	std::vector<uint8_t> message(FRAME_COLUMNS_MAX(width, height) + FRAME_OVERHEAD);
+	std::vector<uint8_t> acked(canvas.bufferSize());     // controller's buffer as of the last ACK
+	std::vector<uint8_t> in_flight(canvas.bufferSize());
+	uint8_t seq = 0;
+	bool waiting = false;
+	bool resync = true;
+	uint32_t sent_at = 0;
+	AckParser parser;
+	Stats stats;
+
+	effects[current]->begin();
+	uint32_t effect_start = millis();
+	uint32_t next_frame = effect_start;
+	uint32_t last_stats = effect_start;
+	bool done = false;
+
+	while (!stopping) {
+		uint32_t now = millis();
+
+		// Render on time, independent of the link
+		if ((int32_t)(now - next_frame) >= 0) {
+			if (done || (!only && now - effect_start >= duration_ms)) {
+				effects[current]->end();
+				if (!only) current = (current + 1) % count;
+				effects[current]->begin();
+				effect_start = now;
+			}
+			done = !effects[current]->tick(now);
+			stats.rendered++;
+			next_frame += effects[current]->frameMs();
+			if ((int32_t)(now - next_frame) >= 0) {
+				next_frame = now + effects[current]->frameMs();
+				stats.overruns++;
+			}
+		}
+
+		// Send the newest frame once the last message is acknowledged
+		if (!waiting) {
+			uint8_t* payload = message.data() + FRAME_HEADER_SIZE;
+			uint16_t len = frameEncodeColumns(resync ? NULL : acked.data(), canvas.buffer(), width, height, payload);
+			uint8_t type = FRAME_COLUMNS;
+			if (len == bitmap_size) {
+				// Nothing changed, only keep the controller streaming
+				type = FRAME_HELLO;
+				len = 0;
+			}
+			if (type == FRAME_COLUMNS || now - sent_at >= KEEPALIVE_MS) {
+				const uint16_t size = frameBuild(type, ++seq, payload, len, message.data());
+				if (!writeAll(fd, message.data(), size)) {
+					perror("write");
+					break;
+				}
+				memcpy(in_flight.data(), type == FRAME_HELLO ? acked.data() : canvas.buffer(), in_flight.size());
+				waiting = true;
+				sent_at = now;
+				stats.messages++;
+				stats.bytes += size;
+			}
+		}
+
+		// Wait for the ACK or the next frame, whichever comes first
+		int32_t timeout = next_frame - now;
+		if (waiting && (int32_t)(sent_at + ACK_TIMEOUT_MS - now) < timeout) {
+			timeout = sent_at + ACK_TIMEOUT_MS - now;
+		}
+		struct pollfd pfd = { fd, POLLIN, 0 };
+		if (poll(&pfd, 1, timeout > 0 ? timeout : 0) > 0) {
+			uint8_t rx[64];
+			const ssize_t n = read(fd, rx, sizeof(rx));
+			for (ssize_t i = 0; i < n; i++) {
+				const FrameStatus status = parser.feed(rx[i]);
+				if (status == FRAME_PENDING || !waiting) continue;
+				// Late for a message that timed out
+				if (status != FRAME_BAD_CRC && parser.seq() != seq) continue;
+				waiting = false;
+				stats.ack_ms += millis() - sent_at;
+				if (status == FRAME_OK) {
+					acked.swap(in_flight);
+					resync = false;
+				} else {
+					resync = true;
+					stats.resyncs++;
+				}
+			}
+		}
+
+		now = millis();
+		if (waiting && now - sent_at >= ACK_TIMEOUT_MS) {
+			waiting = false;
+			resync = true;
+			stats.resyncs++;
+		}
+		if (verbose && now - last_stats >= 10000) {
+			printStats(stats);
+			last_stats = now;
+		}
+	}
+
+	printStats(stats);
+	close(fd);
+	return 0;
+}
@@ -0,0 +1,187 @@
+// ENABLE pulse checker: reads a VCD trace of the ENABLE line, as simavr
+// writes it for the profiling firmware (src/profile/profile.cpp), and
+// checks every strobe against the driver's timing. A strobe is ENABLE low
+// for the flip time, high for twice that and low again for the flip time
+// (BROSE9323::_strobe() and the flip engine). A low pulse shorter than the
+// flip time may leave the dot unflipped, a longer one heats the coil.
+//
+//   pulsecheck [-t flip_us] [-s slack_us] [-n signal] trace.vcd
+//
+// Pulses may be up to slack_us (20) longer than asked for, the pin writes
+// around the delays take some time too. Prints the pulse statistics and
+// every violation, and exits with 1 if there was one.
+//
+// Build with the PlatformIO "pulsecheck" environment: pio run -e pulsecheck
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+
+// Violations printed one by one, the rest are only counted
+static const int MAX_LISTED = 20;
+
+struct Range {
+	double min = 1e300;
+	double max = 0;
+	unsigned long count = 0;
+
+	void add(double us) {
+		if (us < min) min = us;
+		if (us > max) max = us;
+		count++;
+	}
+};
+
+// Reads the next whitespace separated token, false at the end
+static bool token(FILE* f, std::string& s) {
+	s.clear();
+	int c;
+	while ((c = fgetc(f)) != EOF && (c == ' ' || c == '\t' || c == '\r' || c == '\n')) {}
+	while (c != EOF && c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+		s += (char)c;
+		c = fgetc(f);
+	}
+	return !s.empty();
+}
+
+// Microseconds per VCD time unit, from "1ns", "10 us" and the like
+static double timescale(const std::string& scale) {
+	const double n = atof(scale.c_str());
+	const char* unit = scale.c_str() + strspn(scale.c_str(), "0123456789. ");
+	if (!strcmp(unit, "s")) return n * 1e6;
+	if (!strcmp(unit, "ms")) return n * 1e3;
+	if (!strcmp(unit, "us")) return n;
+	if (!strcmp(unit, "ns")) return n * 1e-3;
+	if (!strcmp(unit, "ps")) return n * 1e-6;
+	if (!strcmp(unit, "fs")) return n * 1e-9;
+	return 0;
+}
+
+static void usage(void) {
+	fprintf(stderr, "usage: pulsecheck [-t flip_us] [-s slack_us] [-n signal] trace.vcd\n");
+	exit(2);
+}
+
+int main(int argc, char** argv) {
+	double flip_us = 280;
+	double slack_us = 20;
+	const char* signal = "ENABLE";
+
+	int opt;
+	while ((opt = getopt(argc, argv, "t:s:n:")) != -1) {
+		switch (opt) {
+			case 't':
+				flip_us = atof(optarg);
+				break;
+			case 's':
+				slack_us = atof(optarg);
+				break;
+			case 'n':
+				signal = optarg;
+				break;
+			default:
+				usage();
+		}
+	}
+	if (optind != argc - 1 || flip_us <= 0 || slack_us < 0) usage();
+
+	FILE* f = fopen(argv[optind], "r");
+	if (!f) {
+		perror(argv[optind]);
+		return 1;
+	}
+
+	// Header: the time unit and the identifier of the signal
+	std::string t;
+	std::string id;
+	double unit_us = 0;
+	while (token(f, t) && t != "$enddefinitions") {
+		if (t == "$timescale") {
+			std::string scale;
+			while (token(f, t) && t != "$end") scale += t;
+			unit_us = timescale(scale);
+		} else if (t == "$var") {
+			// $var wire 1 <id> <name> $end
+			std::string type, size, ref, name;
+			token(f, type);
+			token(f, size);
+			token(f, ref);
+			token(f, name);
+			if (name == signal) id = ref;
+		}
+	}
+	if (unit_us <= 0 || id.empty()) {
+		fprintf(stderr, "%s: no timescale or no signal %s\n", argv[optind], signal);
+		fclose(f);
+		return 1;
+	}
+
+	Range low;
+	Range gap;
+	unsigned long violations = 0;
+	int value = -1;        // unknown before the first change
+	double now = 0;
+	double since = 0;      // time of the last edge
+	bool second = false;   // the next low pulse is the second of a strobe
+
+	// Changes are "0<id>", "1<id>" or, for a vector, "b<bits> <id>"
+	while (token(f, t)) {
+		int v;
+		if (t[0] == '#') {
+			now = atof(t.c_str() + 1) * unit_us;
+			continue;
+		} else if (t[0] == 'b' || t[0] == 'B') {
+			std::string ref;
+			token(f, ref);
+			if (ref != id) continue;
+			v = t.find('1') != std::string::npos;
+		} else if ((t[0] == '0' || t[0] == '1') && t.compare(1, std::string::npos, id) == 0) {
+			v = t[0] == '1';
+		} else {
+			continue;
+		}
+		if (v == value) continue;
+
+		const double width = now - since;
+		const char* problem = NULL;
+		if (value == 0 && v == 1) {
+			// A low pulse ends
+			low.add(width);
+			if (width < flip_us) problem = "low pulse too short";
+			if (width > flip_us + slack_us) problem = "low pulse too long";
+			second = !second;
+		} else if (value == 1 && v == 0 && second) {
+			// The gap between the two low pulses of a strobe ends
+			gap.add(width);
+			if (width < 2 * flip_us) problem = "gap too short";
+			if (width > 2 * flip_us + slack_us) problem = "gap too long";
+		}
+		if (problem) {
+			if (violations < MAX_LISTED) {
+				printf("%12.1f us  %-20s %8.1f us\n", since, problem, width);
+			}
+			violations++;
+		}
+		// The level before the first edge is not a pulse
+		if (value >= 0 || v == 1) since = now;
+		value = value < 0 && v == 0 ? -1 : v;
+	}
+	fclose(f);
+
+	printf("strobes %lu, low pulses %lu\n", low.count / 2, low.count);
+	if (low.count) {
+		printf("low   %8.1f - %8.1f us  (want %.1f - %.1f)\n", low.min, low.max, flip_us, flip_us + slack_us);
+	}
+	if (gap.count) {
+		printf("gap   %8.1f - %8.1f us  (want %.1f - %.1f)\n", gap.min, gap.max, 2 * flip_us, 2 * flip_us + slack_us);
+	}
+	if (low.count & 1) {
+		printf("odd number of low pulses, the last strobe is incomplete\n");
+		violations++;
+	}
+	printf("violations %lu\n", violations);
+	return violations ? 1 : 0;
+}
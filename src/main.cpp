@@ -1,5 +1,14 @@
 #include <Arduino.h>
 #include <BROSE9323.h>
+#include "Animation.h"
+#include "Compositor.h"
+#include "EffectScheduler.h"
+#include "Effects.h"
+#include "FrameReceiver.h"
+#include "MicSampler.h"
+#include "SerialCommand.h"
+#include "TextScroller.h"
+#include "animations/bounce.h"
 
 #define DEBUG 0  // Set to 0 to disable serial debug output
 
@@ -11,16 +20,18 @@
 #define PANEL_WIDTH 28
 #define MIC_PIN 2
 
-BROSE9323 display(WIDTH, HEIGHT, PANEL_WIDTH);
+typedef BROSE9323Fixed<WIDTH, HEIGHT, PANEL_WIDTH> Display;
 
-// Global variable to control program execution
-volatile bool stopProgram = false;
+Display display;
+FrameReceiver frameReceiver(display);
+SerialCommand serialCommand(Serial);
+TextScroller scroller(display);
+MicSampler mic;
 
-// Global variable to track animation start time
-unsigned long animationStartTime = 0;
-int currentAnimationIndex = 0;
+// Streaming ends when no byte arrived for this long
+const unsigned long STREAM_TIMEOUT = 2000;
 
-// Animation duration in milliseconds
+// Time each effect runs before the next one starts
 const unsigned long ANIMATION_DURATION = 10000;  // 10 seconds
 
 const char text[] = "20 YRS OF HOMEMADE";
@@ -32,340 +43,78 @@ void clearDisplay(int delayMs = 0) {
   delay(100);
 }
 
-void setup() {
-  display.begin();
-  clearDisplay();
-
-  display.setTextSize(textsize);
-  display.setTextWrap(false);
-  display.setTextColor(1, 0);
-
-  // Set pin 13 as analog input
-  pinMode(MIC_PIN, INPUT);
-
-  // Initialize serial communication for debugging
-  Serial.begin(115200);
-
-  randomSeed(analogRead(0));
-  delay(100);
-}
-
-void randomFlip() {
-  // Reset stop flag for this program
-  stopProgram = false;
-
-  // Program loop - runs until stopProgram is set to true or 30 seconds pass
-  while (!stopProgram && (millis() - animationStartTime) < ANIMATION_DURATION) {
-    // Check for serial input
-    if (Serial.available() > 0) {
-      stopProgram = true;
-      break;
-    }
-
-    // Flip a random number of dots (between 5 and 30)
-    int numDots = random(5, 100);  // random(5, 31) gives 5 to 30 inclusive
-
-    for (int i = 0; i < numDots; i++) {
-      // Find a random dot on the grid and flip it
-      int x = random(0, WIDTH);
-      int y = random(0, HEIGHT);
-      display.drawPixel(x, y, random(2));
-    }
-    display.display();
-    delay(5);
+// Random dots in the 3 rows above and below the scrolling text
+void drawTextNoise() {
+  for (int i = 0; i < 10; i++) {
+    int row = random(0, 3);
+    int col = random(0, display.width());
+    display.drawPixel(col, row, random(2));
   }
-}
-
-void randomFlicker() {
-  // Reset stop flag for this program
-  stopProgram = false;
-
-  // Program loop - runs until stopProgram is set to true or 30 seconds pass
-  while (!stopProgram && (millis() - animationStartTime) < ANIMATION_DURATION) {
-    // Check for serial input
-    if (Serial.available() > 0) {
-      stopProgram = true;
-      break;
-    }
-
-    // Set entire screen to random black or white using drawPixel
-    int color = random(2);
-    for (int x = 0; x < WIDTH; x++) {
-      for (int y = 0; y < HEIGHT; y++) {
-        display.drawPixel(x, y, color);
-      }
-    }
-    display.display();
-
-    // Random delay between 20-100ms (faster than before)
-    delay(random(20, 101));
+  for (int i = 0; i < 10; i++) {
+    int row = random(display.height() - 3, display.height());
+    int col = random(0, display.width());
+    display.drawPixel(col, row, random(2));
   }
 }
 
-void sweep() {
-  // Reset stop flag for this program
-  stopProgram = false;
-
-  // Buffer to store column colors (one extra column to handle the shift)
-  int columnColors[WIDTH + 1];
-
-  // Initialize with alternating pattern
-  for (int i = 0; i < WIDTH + 1; i++) {
-    columnColors[i] = (i % 2) ? 0 : 1;
-  }
-
-  // Program loop - runs until stopProgram is set to true or 30 seconds pass
-  while (!stopProgram && (millis() - animationStartTime) < ANIMATION_DURATION) {
-    // Check for serial input
-    if (Serial.available() > 0) {
-      stopProgram = true;
-      break;
-    }
+class TextEffect : public Effect {
+  public:
+    TextEffect() : Effect("drawText", 50) {}
 
-    // Shift all column colors one step to the right
-    for (int x = WIDTH; x > 0; x--) {
-      columnColors[x] = columnColors[x - 1];
+    void begin() {
+      display.fillScreen(0);
+      scroller.begin(text);
     }
 
-    // Add new column color on the left (alternating pattern)
-    static int columnCounter = 0;
-    columnColors[0] = (columnCounter % 2) ? 0 : 1;
-    columnCounter++;
-
-    // Draw all columns based on the buffer
-    for (int x = 0; x < WIDTH; x++) {
-      for (int y = 0; y < HEIGHT; y++) {
-        display.drawPixel(x, y, columnColors[x]);
-      }
+    bool tick(unsigned long) {
+      // Text in the middle moved one column above
+      if (!scroller.step()) return false;
+      drawTextNoise();
+      return true;
     }
+};
 
-    display.display();
-    delay(50);  // Animation speed
-  }
-}
+class SoundEffect : public Effect {
+  private:
+    const bool simulate;
 
-void lines() {
-  // Reset stop flag for this program
-  stopProgram = false;
+  public:
+    SoundEffect(bool simulate = false) : Effect("sound", 10), simulate(simulate) {}
 
-  // Program loop - runs until stopProgram is set to true or 30 seconds pass
-  while (!stopProgram && (millis() - animationStartTime) < ANIMATION_DURATION) {
-    // Check for serial input
-    if (Serial.available() > 0) {
-      stopProgram = true;
-      break;
-    }
+    bool tick(unsigned long) {
+      int micValue;
 
-    // Randomly flip whole columns across the entire width
-    for (int x = 0; x < WIDTH; x++) {
-      // Randomly decide if this column should be flipped
-      if (random(2)) {
-        // Flip the entire column to random color
-        int color = random(2);
-        for (int y = 0; y < HEIGHT; y++) {
-          display.drawPixel(x, y, color);
-        }
+      if (simulate) {
+        // Generate random microphone values for simulation
+        micValue = random(0, 50000);  // Random values between 0 and 50000
+      } else {
+        // Only beats draw a circle, sized by the envelope
+        mic.update(micros());
+        micValue = mic.onset() ? mic.level() : 0;
       }
-    }
-
-    delay(random(1, 10));  // Delay between updates
-  }
-}
-
-void drawText() {
-  clearDisplay();
-
-  for (int16_t x = display.width(); x > -((int16_t)strlen(text) * textsize * 6); x--) {
-    // Randomize first 3 rows (20 random pixels)
-    for (int i = 0; i < 10; i++) {
-      int row = random(0, 3);
-      int col = random(0, display.width());
-      display.drawPixel(col, row, random(2));
-    }
-
-    // Randomize last 3 rows (20 random pixels)
-    for (int i = 0; i < 10; i++) {
-      int row = random(display.height() - 3, display.height());
-      int col = random(0, display.width());
-      display.drawPixel(col, row, random(2));
-    }
-
-    // Draw scrolling text in the middle
-    display.setCursor(x, 4);
-    display.print(text);
-    display.display();
-  }
-}
-
-void displayReceivedText(String customText) {
-  animationStartTime = millis();
-  clearDisplay();
-  delay(100);
-
-  // Convert String to char array for compatibility
-  char textBuffer[100];
-  customText.toCharArray(textBuffer, sizeof(textBuffer));
-
-  // Calculate text width for scrolling
-  int textWidth = customText.length() * textsize * 6;
-
-  for (int16_t x = display.width(); x > -textWidth; x--) {
-    // Randomize first 3 rows (10 random pixels)
-    for (int i = 0; i < 10; i++) {
-      int row = random(0, 3);
-      int col = random(0, display.width());
-      display.drawPixel(col, row, random(2));
-    }
-
-    // Randomize last 3 rows (10 random pixels)
-    for (int i = 0; i < 10; i++) {
-      int row = random(display.height() - 3, display.height());
-      int col = random(0, display.width());
-      display.drawPixel(col, row, random(2));
-    }
 
-    // Draw scrolling custom text in the middle
-    display.setCursor(x, 4);
-    display.print(customText);
-    display.display();
-
-    // Check for timeout
-    if ((millis() - animationStartTime) >= ANIMATION_DURATION * 1.5) {
-      break;
-    }
-
-    // Check for serial input
-    if (Serial.available() > 0) {
-      stopProgram = true;
-      break;
-    }
-  }
-}
-
-void matrix() {
-  // Reset stop flag for this program
-  stopProgram = false;
-
-  // Matrix rain drops - each drop has position and speed
-  struct RainDrop {
-    int x;
-    int y;
-    int speed;
-    int brightness;
-  };
-
-  RainDrop drops[WIDTH / 2];
-
-  // Initialize rain drops
-  for (int i = 0; i < WIDTH / 2; i++) {
-    drops[i].x = random(0, WIDTH);  // Random x position instead of fixed
-    drops[i].y = random(-HEIGHT, 0);
-    drops[i].speed = random(1, 4);
-    drops[i].brightness = random(1, 3);
-  }
-
-  // Program loop - runs until stopProgram is set to true or timeout
-  while (!stopProgram && (millis() - animationStartTime) < ANIMATION_DURATION) {
-    // Check for serial input
-    if (Serial.available() > 0) {
-      stopProgram = true;
-      break;
-    }
-
-    // Clear screen to black manually
-    for (int x = 0; x < WIDTH; x++) {
-      for (int y = 0; y < HEIGHT; y++) {
-        display.drawPixel(x, y, 0);
-      }
-    }
-
-    // Update and draw rain drops
-    for (int i = 0; i < WIDTH / 2; i++) {
-      // Move drop down
-      drops[i].y += drops[i].speed;
-
-      // If drop goes off screen, reset it to top
-      if (drops[i].y >= HEIGHT) {
-        drops[i].y = random(-HEIGHT, 0);
-        drops[i].speed = random(1, 4);
-        drops[i].brightness = random(1, 3);
-      }
-
-      // Draw the rain drop trail
-      for (int trail = 0; trail < 8; trail++) {
-        int trailY = drops[i].y - trail;
-        if (trailY >= 0 && trailY < HEIGHT) {
-          // Fade brightness along the trail
-          int brightness = drops[i].brightness - (trail / 2);
-          if (brightness > 0) {
-            display.drawPixel(drops[i].x, trailY, brightness);
-          }
-        }
-      }
-    }
-
-    // Add random flashing effects
-    if (random(100) < 5) {  // 5% chance each frame
-      // Flash random horizontal line
-      int flashY = random(0, HEIGHT);
-      for (int x = 0; x < WIDTH; x++) {
-        display.drawPixel(x, flashY, 1);
-      }
-    }
-
-    // Add random sparkles
-    for (int sparkle = 0; sparkle < 3; sparkle++) {
-      if (random(100) < 10) {  // 10% chance each sparkle
-        int sparkleX = random(0, WIDTH);
-        int sparkleY = random(0, HEIGHT);
-        display.drawPixel(sparkleX, sparkleY, 1);
+      if (DEBUG) {
+        Serial.print(F("Microphone value: "));
+        Serial.println(micValue);
       }
-    }
 
-    display.display();
-    delay(50);
-  }
-}
+      // Check if sound level is above threshold (90), a circle stays for
+      // 100ms
+      _frame_ms = 10;
+      if (micValue <= 90) return true;
 
-void sound(bool simulate = false) {
-  // Reset stop flag for this program
-  stopProgram = false;
-  int circleColor = 0;
-
-  // Program loop - runs until stopProgram is set to true or timeout
-  while (!stopProgram && (millis() - animationStartTime) < ANIMATION_DURATION) {
-    // Read analog microphone value from pin 19
-    int micValue;
-
-    if (simulate) {
-      // Generate random microphone values for simulation
-      micValue = random(0, 50000);  // Random values between 0 and 50000
-    } else {
-      // Read actual microphone value
-      micValue = pulseIn(MIC_PIN, HIGH);
-    }
-
-    if (DEBUG) {
-      Serial.print("Microphone value: ");
-      Serial.println(micValue);
-    }
-    // Check if sound level is above threshold (90)
-    if (micValue > 90) {
-      // Debug: output sensor value to serial
-
-      // Calculate circle radius based on sound level (90-120 range)
-      // Map 90-120 to radius 1-4
+      // Map the level to radius 2-8
       int radius = map(micValue, 0, 30000, 2, 8);
-      circleColor = random(2);
+      int circleColor = random(2);
 
       // Debug: output circle details
       if (DEBUG) {
-        Serial.print("Drawing circle - Radius: ");
+        Serial.print(F("Drawing circle - Radius: "));
         Serial.print(radius);
-        Serial.print(", Value: ");
+        Serial.print(F(", Value: "));
         Serial.print(micValue);
 
-        Serial.print(", Color: ");
+        Serial.print(F(", Color: "));
         Serial.println(circleColor);
       }
 
@@ -373,8 +122,6 @@ void sound(bool simulate = false) {
       int centerX = random(radius, WIDTH - radius);
       int centerY = random(radius, HEIGHT - radius);
 
-      // Randomly choose circle color (black or white)
-
       // Draw filled circle manually using drawPixel
       for (int y = -radius; y <= radius; y++) {
         for (int x = -radius; x <= radius; x++) {
@@ -389,80 +136,238 @@ void sound(bool simulate = false) {
           }
         }
       }
-      display.display();
-      delay(100);
+      _frame_ms = 110;
+      return true;
     }
+};
+
+// matrix redraws every frame from scratch. It does so into its own layer,
+// flatten() then changes only the dots that differ from the last frame.
+StaticLayer<WIDTH, HEIGHT> rainLayer;
+Layer* const layers[] = { &rainLayer };
+Compositor compositor(display, layers, sizeof(layers) / sizeof(layers[0]));
+
+class LayeredMatrixEffect : public MatrixEffect<Layer, WIDTH / 2> {
+  public:
+    LayeredMatrixEffect() : MatrixEffect<Layer, WIDTH / 2>(rainLayer) {}
+
+    bool tick(unsigned long now) {
+      const bool running = MatrixEffect<Layer, WIDTH / 2>::tick(now);
+      compositor.flatten();
+      return running;
+    }
+};
+
+// The portable effects are shared with the host renderer
+LayeredMatrixEffect matrixEffect;
+RandomFlipEffect<Display> randomFlipEffect(display);
+SweepEffect<Display> sweepEffect(display);
+RandomFlickerEffect<Display> randomFlickerEffect(display);
+LinesEffect<Display> linesEffect(display);
+TextEffect textEffect;
+// Pre-encoded in flash, see src/animations/bounce.py
+AnimationEffect<Display> bounceEffect(display, "bounce", bounceAnimation);
+SoundEffect soundEffect;
+
+// Effects in the order they rotate, !fx selects them by index. sound needs
+// the microphone, so it only runs when selected.
+Effect* const effects[] = {
+  &matrixEffect,
+  &randomFlipEffect,
+  &sweepEffect,
+  &randomFlickerEffect,
+  &linesEffect,
+  &textEffect,
+  &bounceEffect,
+  &soundEffect
+};
+const uint8_t numRotating = 7;
+
+EffectScheduler scheduler(display, effects, sizeof(effects) / sizeof(effects[0]), ANIMATION_DURATION);
 
-    delay(10);
-  }
+void setup() {
+  display.begin();
+  clearDisplay();
+
+  display.setTextSize(textsize);
+  display.setTextWrap(false);
+  display.setTextColor(1, 0);
+
+  // The microphone's pulses are timed by the pin's interrupt
+  mic.begin(MIC_PIN);
+
+  // Initialize serial communication for debugging
+  Serial.begin(115200);
+
+  randomSeed(analogRead(0));
+  EffectRandom::seed(random(1, 0x7FFFFFFF));
+  scheduler.setRotation(numRotating);
+  delay(100);
 }
 
-void loop() {
-  // Main loop - cycles through different animations every 30 seconds
+void displayReceivedText(const char* customText) {
+  unsigned long startTime = millis();
+  clearDisplay();
+  delay(100);
 
-  // Array of animation function names for reference
-  const char* animationNames[] = {"matrix", "sound", "sweep", "randomFlip", "randomFlicker", "lines", "drawText"};
-  int numAnimations = 7;
+  scroller.begin(customText);
+  while (scroller.step()) {
+    drawTextNoise();
 
-  while (true) {
-    // Check for serial input before starting each animation
-    if (Serial.available() > 0) {
-      // Wait a bit for complete data to arrive
-      delay(10);
-
-      // Read the incoming text
-      String receivedText = Serial.readString();
-      receivedText.trim();  // Remove any whitespace
-
-      if (receivedText.length() > 0) {
-        stopProgram = true;
-        Serial.print("Received text: ");
-        Serial.println(receivedText);
-
-        // Display the received text
-        displayReceivedText(receivedText);
-        stopProgram = false;
-        // Continue with normal animation cycle
-        continue;
-      }
+    // Custom text in the middle moved one column above
+    display.display();
+
+    // Check for timeout
+    if ((millis() - startTime) >= ANIMATION_DURATION * 1.5) {
+      break;
     }
 
-    // Start the current animation
-    if (DEBUG) {
-      Serial.print("Starting animation: ");
-      Serial.println(animationNames[currentAnimationIndex]);
+    // The text still sits in the command buffer, so stop on the first byte
+    // of the next line and leave reading it to the main loop
+    if (Serial.available() > 0) {
+      break;
     }
+  }
+}
 
-    // Record start time and reset stop flag
-    animationStartTime = millis();
-    stopProgram = false;
-
-    // Run the current animation
-    switch (currentAnimationIndex) {
-      case 0:
-        matrix();
-        break;
-      case 1:
-        randomFlip();
-        break;
-      case 2:
-        sweep();
-        break;
-      case 3:
-        randomFlicker();
-        break;
-      case 4:
-        lines();
-        break;
-      case 5:
-        drawText();
-        break;
+// Shows binary frames streamed by the host until the stream goes quiet.
+// Every frame is acknowledged once it is on the panel, so the host never
+// has more than one frame in flight.
+void streamFrames() {
+  uint8_t ack[FRAME_OVERHEAD + 2];
+  unsigned long lastByte = millis();
+
+  while (millis() - lastByte < STREAM_TIMEOUT) {
+    while (Serial.available() > 0) {
+      lastByte = millis();
+      FrameStatus status = frameReceiver.feed(Serial.read());
+      if (status == FRAME_PENDING) continue;
+
+      if (status == FRAME_OK && frameReceiver.type() != FRAME_HELLO) {
+        display.display();
+      }
+      Serial.write(ack, frameReceiver.ack(status, ack));
+      lastByte = millis();
     }
+  }
+}
 
-    // Move to next animation
-    currentAnimationIndex = (currentAnimationIndex + 1) % numAnimations;
+// Runs a command that arrived over serial
+void handleCommand() {
+  switch (serialCommand.type()) {
+    case CMD_STREAM:
+      serialCommand.clear();
+      streamFrames();
+      scheduler.restart();
+      break;
+    case CMD_TEXT:
+      Serial.print(F("Received text: "));
+      Serial.println(serialCommand.argument());
+
+      // Display the received text, scrolled straight from the command buffer
+      displayReceivedText(serialCommand.argument());
+      serialCommand.clear();
+      scheduler.restart();
+      break;
+    case CMD_EFFECT: {
+      const char* argument = serialCommand.argument();
+      int index = atoi(argument);
+      if (argument[0] >= '0' && argument[0] <= '9' && index < scheduler.count()) {
+        scheduler.select(index);
+        Serial.print(F("ok effect "));
+        Serial.println(scheduler.effect(index)->name());
+      } else {
+        Serial.println(F("error effect"));
+      }
+      serialCommand.clear();
+      break;
+    }
+    case CMD_TIMING: {
+      long flipTime = atol(serialCommand.argument());
+      if (flipTime > 0 && flipTime <= 10000) {
+        display.setTiming(flipTime);
+        Serial.print(F("ok timing "));
+        Serial.println(flipTime);
+      } else {
+        Serial.println(F("error timing"));
+      }
+      serialCommand.clear();
+      break;
+    }
+    case CMD_FLIPS: {
+      const char* argument = serialCommand.argument();
+      long limit = atol(argument);
+      if (argument[0] >= '0' && argument[0] <= '9' && limit <= 65535) {
+        display.setFlipLimit(limit);
+        Serial.print(F("ok flips "));
+        Serial.println(limit);
+      } else {
+        Serial.println(F("error flips"));
+      }
+      serialCommand.clear();
+      break;
+    }
+    case CMD_STATS:
+      Serial.print(F("stats effect="));
+      Serial.print(scheduler.current());
+      Serial.print(F(" flip_us="));
+      Serial.print(display.getTiming());
+      Serial.print(F(" pending="));
+      Serial.print(display.pending());
+      Serial.print(F(" converge_us="));
+      Serial.print(display.convergenceMicros());
+      Serial.print(F(" frames="));
+      Serial.print(scheduler.frames());
+      Serial.print(F(" overruns="));
+      Serial.print(scheduler.overruns());
+      Serial.print(F(" uptime_ms="));
+      Serial.println(millis());
+      serialCommand.clear();
+      break;
+    case CMD_COUNTERS: {
+#ifdef BROSE9323_COUNTERS
+      // One line of key=value pairs, then the counting starts over
+      BROSE9323::Counters counters = display.counters();
+      display.resetCounters();
+      Serial.print(F("counters strobes="));
+      Serial.print(counters.strobes);
+      Serial.print(F(" pin_writes="));
+      Serial.print(counters.pin_writes);
+      Serial.print(F(" noop_pixels="));
+      Serial.print(counters.noop_pixels);
+      Serial.print(F(" displays="));
+      Serial.print(counters.displays);
+      Serial.print(F(" dots_diffed="));
+      Serial.print(counters.dots_diffed);
+      Serial.print(F(" display_us_min="));
+      Serial.print(counters.displays ? counters.display_us_min : 0);
+      Serial.print(F(" display_us_avg="));
+      Serial.print(counters.displays ? counters.display_us_sum / counters.displays : 0);
+      Serial.print(F(" display_us_max="));
+      Serial.println(counters.display_us_max);
+#else
+      Serial.println(F("error counters disabled"));
+#endif
+      serialCommand.clear();
+      break;
+    }
+    case CMD_TOO_LONG:
+      Serial.println(F("error too long"));
+      serialCommand.clear();
+      break;
+    default:
+      Serial.print(F("error unknown "));
+      Serial.println(serialCommand.argument());
+      serialCommand.clear();
+      break;
+  }
+}
 
-    // Brief pause between animations
-    delay(10);
+void loop() {
+  // Commands are handled between frames, an effect switch takes effect at
+  // the next frame boundary
+  if (serialCommand.poll()) {
+    handleCommand();
   }
+  scheduler.run();
 }
@@ -0,0 +1,245 @@
+// Profiling firmware: times the driver's hot paths in CPU cycles on fixed
+// frames and prints a table with one row per measurement. Cycles are
+// counted with Timer1 running at the CPU clock, so they are exact on an Uno
+// and do not change from run to run under simavr, where the table can be
+// diffed between commits:
+//
+//   pio run -e profile
+//   simavr -m atmega328p -f 16000000 .pio/build/profile/firmware.elf
+//
+// Under simavr the ENABLE line is also written to profile.vcd (see
+// trace.c), src/host/pulsecheck.cpp checks its pulse widths:
+//
+//   pio run -e pulsecheck && .pio/build/pulsecheck/program -t 280 profile.vcd
+//
+// src/profile/run.sh does all of that in one go.
+//
+// Timer0 and the serial interrupt are kept quiet while measuring, so the
+// counts are those of the code alone. On a real Uno the frames are flipped
+// as usual. The firmware ends asleep with interrupts off, which also ends
+// simavr.
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include <BROSE9323.h>
+#include "../Effects.h"
+
+#define WIDTH 84
+#define HEIGHT 16
+#define PANEL_WIDTH 28
+#define FLIP_TIME 280
+
+// A pin the display does not use, for timing digitalWrite()
+#define SPARE_PIN 2
+
+typedef BROSE9323Fixed<WIDTH, HEIGHT, PANEL_WIDTH> Display;
+
+Display display(FLIP_TIME);
+
+// Reaches the driver's pin level functions
+class BROSE9323Profile {
+	public:
+		static void selectColumn(BROSE9323& d, uint8_t col) { d._selectColumn(col); }
+		static void strobe(BROSE9323& d) { d._strobe(); }
+};
+
+static volatile uint16_t overflows = 0;
+
+ISR(TIMER1_OVF_vect) {
+	overflows++;
+}
+
+// Cycles since the timer started
+static uint32_t cycles(void) {
+	const uint8_t sreg = SREG;
+	cli();
+	const uint16_t count = TCNT1;
+	uint16_t high = overflows;
+	// An overflow that happened after cli() is still pending
+	if ((TIFR1 & _BV(TOV1)) && count < 0x8000) high++;
+	SREG = sreg;
+	return (uint32_t)high << 16 | count;
+}
+
+static uint32_t overhead = 0;  // cycles of a start() and stop() around nothing
+
+// Collects the cycles of the calls between start() and stop()
+class Probe {
+	private:
+		const char* const _name;
+		uint32_t _start;
+		uint32_t _min = 0xFFFFFFFF;
+		uint32_t _max = 0;
+		uint32_t _sum = 0;
+		uint16_t _calls = 0;
+	public:
+		Probe(const char* name) : _name(name) {}
+
+		void start(void) { _start = cycles(); }
+
+		void stop(void) {
+			uint32_t c = cycles() - _start;
+			c = c > overhead ? c - overhead : 0;
+			if (c < _min) _min = c;
+			if (c > _max) _max = c;
+			_sum += c;
+			_calls++;
+		}
+
+		void print(void) {
+			char line[72];
+			snprintf(line, sizeof(line), "%-28s %6u %10lu %10lu %10lu", _name, _calls,
+				(unsigned long)(_calls ? _min : 0), (unsigned long)(_calls ? _sum / _calls : 0), (unsigned long)_max);
+			Serial.println(line);
+			Serial.flush();
+		}
+
+		static void printHeading(void) {
+			char line[72];
+			snprintf(line, sizeof(line), "%-28s %6s %10s %10s %10s", "# function", "calls", "min", "avg", "max");
+			Serial.println(line);
+			Serial.flush();
+		}
+};
+
+static void calibrate(void) {
+	uint32_t least = 0xFFFFFFFF;
+	for (uint8_t i = 0; i < 16; i++) {
+		const uint32_t start = cycles();
+		const uint32_t c = cycles() - start;
+		if (c < least) least = c;
+	}
+	overhead = least;
+}
+
+// Brings the panel to a blank frame, not timed
+static void blank(void) {
+	display.fillScreen(0);
+	display.display();
+}
+
+// Fixed frames drawn onto a blank one
+static void oneDot(void) {
+	display.drawPixel(WIDTH / 2, HEIGHT / 2, 1);
+}
+
+static void fiveDots(void) {
+	EffectRandom::seed(1);
+	for (uint8_t i = 0; i < 5; i++) {
+		display.drawPixel(EffectRandom::below(WIDTH), EffectRandom::below(HEIGHT), 1);
+	}
+}
+
+static void text(void) {
+	display.setCursor(1, 4);
+	display.print("FLIPDOT 9323");
+}
+
+static void checkerboard(void) {
+	for (uint8_t y = 0; y < HEIGHT; y++) {
+		for (uint8_t x = 0; x < WIDTH; x++) {
+			display.drawPixel(x, y, (x ^ y) & 1);
+		}
+	}
+}
+
+// planFlips() and display() of a frame, each from the blank frame
+static void profileFrame(const char* plan_name, const char* display_name, void (*draw)(void)) {
+	Probe plan(plan_name);
+	Probe show(display_name);
+	for (uint8_t i = 0; i < 3; i++) {
+		blank();
+		draw();
+		plan.start();
+		display.planFlips();
+		plan.stop();
+		show.start();
+		display.display();
+		show.stop();
+	}
+	plan.print();
+	show.print();
+}
+
+void setup() {
+	Serial.begin(115200);
+	display.begin();
+	display.setTextColor(1, 0);
+	display.setTextWrap(false);
+	pinMode(SPARE_PIN, OUTPUT);
+
+	// Timer1 counts every CPU cycle, millis() is not needed
+	TCCR1A = 0;
+	TCCR1B = _BV(CS10);
+	TIMSK1 = _BV(TOIE1);
+	TIMSK0 = 0;
+	calibrate();
+
+	Serial.println(F("# BROSE9323 profile, 84x16 in 3 panels, cycles at 16 MHz"));
+	Probe::printHeading();
+
+	Probe digital("digitalWrite");
+	for (uint16_t i = 0; i < 256; i++) {
+		digital.start();
+		digitalWrite(SPARE_PIN, i & 1);
+		digital.stop();
+	}
+	digital.print();
+
+	// Every call a different column, the same one is skipped
+	Probe column("_selectColumn");
+	for (uint16_t i = 0; i < 256; i++) {
+		column.start();
+		BROSE9323Profile::selectColumn(display, i & 31);
+		column.stop();
+	}
+	column.print();
+
+	Probe strobe("_strobe");
+	for (uint8_t i = 0; i < 8; i++) {
+		strobe.start();
+		BROSE9323Profile::strobe(display);
+		strobe.stop();
+	}
+	strobe.print();
+
+	// Through the concrete type, as effects templated on the display do,
+	// and through Adafruit_GFX as its text and shapes do
+	Probe pixel("drawPixel");
+	EffectRandom::seed(2);
+	for (uint16_t i = 0; i < 256; i++) {
+		const uint8_t x = EffectRandom::below(WIDTH);
+		const uint8_t y = EffectRandom::below(HEIGHT);
+		pixel.start();
+		display.drawPixel(x, y, i & 1);
+		pixel.stop();
+	}
+	Probe gfx_pixel("drawPixel (Adafruit_GFX)");
+	Adafruit_GFX& gfx = display;
+	EffectRandom::seed(2);
+	for (uint16_t i = 0; i < 256; i++) {
+		const uint8_t x = EffectRandom::below(WIDTH);
+		const uint8_t y = EffectRandom::below(HEIGHT);
+		gfx_pixel.start();
+		gfx.drawPixel(x, y, i & 2);
+		gfx_pixel.stop();
+	}
+	pixel.print();
+	gfx_pixel.print();
+
+	profileFrame("planFlips, unchanged", "display, unchanged", blank);
+	profileFrame("planFlips, 1 dot", "display, 1 dot", oneDot);
+	profileFrame("planFlips, 5 dots", "display, 5 dots", fiveDots);
+	profileFrame("planFlips, text", "display, text", text);
+	profileFrame("planFlips, checkerboard", "display, checkerboard", checkerboard);
+
+	Serial.println(F("# done"));
+	Serial.flush();
+	cli();
+	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+	sleep_enable();
+	sleep_cpu();
+}
+
+void loop() {
+}
@@ -0,0 +1,29 @@
+#!/bin/sh
+# Builds the profiling firmware, runs it under simavr, which prints the
+# cycle table, and checks the ENABLE pulses of its trace with pulsecheck.
+# Exits non-zero if a step fails or a pulse is off.
+#
+#   src/profile/run.sh
+#
+# Needs PlatformIO, simavr and simavr's headers, found through pkg-config
+# or $SIMAVR_INCLUDE (see src/profile/simavr.py). $SIMAVR overrides the
+# simavr binary.
+
+set -e
+cd "$(dirname "$0")/../.."
+
+# FLIP_TIME of profile.cpp
+flip_us=280
+
+pio run -e profile
+pio run -e pulsecheck
+
+# The firmware ends asleep with interrupts off, which ends simavr
+rm -f profile.vcd
+"${SIMAVR:-simavr}" -m atmega328p -f 16000000 .pio/build/profile/firmware.elf
+
+if [ ! -f profile.vcd ]; then
+	echo "no profile.vcd, the firmware was built without simavr's avr_mcu_section.h" >&2
+	exit 1
+fi
+.pio/build/pulsecheck/program -t "$flip_us" profile.vcd
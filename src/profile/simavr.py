@@ -0,0 +1,22 @@
+# Adds the directory of simavr's avr_mcu_section.h to the profile build.
+# $SIMAVR_INCLUDE names it, otherwise it is simavr/avr/ below the include
+# directory pkg-config has for simavr. Without either trace.c leaves the
+# .mmcu section out and simavr writes no trace.
+import os
+import subprocess
+
+Import("env")
+
+include = os.environ.get("SIMAVR_INCLUDE")
+if not include:
+    try:
+        prefix = subprocess.check_output(
+            ["pkg-config", "--variable=includedir", "simavr"], universal_newlines=True).strip()
+        include = os.path.join(prefix, "simavr", "avr")
+    except (OSError, subprocess.CalledProcessError):
+        pass
+
+if include and os.path.isfile(os.path.join(include, "avr_mcu_section.h")):
+    env.Append(CPPPATH=[include])
+else:
+    print("simavr's avr_mcu_section.h not found, set SIMAVR_INCLUDE to its directory")
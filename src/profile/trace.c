@@ -0,0 +1,23 @@
+// Tells simavr to write the ENABLE line to profile.vcd while it runs the
+// profiling firmware. simavr reads this from the .mmcu section of the ELF,
+// on the controller the section is not even loaded. Without simavr's
+// headers installed there is nothing to trace.
+#if defined(__has_include) && __has_include(<avr_mcu_section.h>)
+#include <avr/io.h>
+#include <avr_mcu_section.h>
+
+// ENABLE is D7, or D3 with the PLCC adapter (define FLIPDOT_PLCC_ADAPTER in
+// the build flags of the profile environment then)
+#ifdef FLIPDOT_PLCC_ADAPTER
+#define ENABLE_MASK _BV(PD3)
+#else
+#define ENABLE_MASK _BV(PD7)
+#endif
+
+AVR_MCU(F_CPU, "atmega328p");
+AVR_MCU_VCD_FILE("profile.vcd", 1000);
+
+const struct avr_mmcu_vcd_trace_t _enable_trace[] _MMCU_ = {
+	{ AVR_MCU_VCD_SYMBOL("ENABLE"), .mask = ENABLE_MASK, .what = (void*)&PORTD, },
+};
+#endif
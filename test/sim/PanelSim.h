@@ -0,0 +1,158 @@
+#ifndef PANEL_SIM_H
+#define PANEL_SIM_H
+
+// Simulated BROSE 9323 panels for the host tests. Listens to the pins of
+// the Arduino stand-in (test/stubs/Arduino.h) and does what the panels'
+// drivers do: while ENABLE is low the coil that the ADDR, COL and ROW lines
+// select is driven towards the color the data lines select. Dots are kept
+// by coil address, so a test checks the driver's addressing as well.
+//
+//   simReset();
+//   panelSim().begin();
+//   BROSE9323 display(84, 16, 28);
+//   ...
+//   TEST_ASSERT_EQUAL(0, panelSim().mismatches(display));
+
+#include <Arduino.h>
+#include <BROSE9323.h>
+
+class PanelSim {
+	public:
+		// Arduino pins of the lines, as BROSE9323.h assigns them
+		struct Wiring {
+			uint8_t enable;
+			uint8_t addr[3];
+			uint8_t col[5];
+			uint8_t row[5];
+			uint8_t col_data;
+			uint8_t row_reset;
+			uint8_t row_set;
+		};
+
+		static Wiring defaultWiring(void) {
+			return {7, {3, 5, 6}, {8, 10, 9, 11, 12}, {A3, A4, A2, A0, A1}, 4, 13, A5};
+		}
+
+		static Wiring plccWiring(void) {
+			return {3, {7, 6, 5}, {12, 11, 10, 9, 8}, {13, A0, A1, A2, A3}, 4, A4, A5};
+		}
+
+		// The wiring the driver is built for
+		static Wiring builtWiring(void) {
+#ifdef FLIPDOT_PLCC_ADAPTER
+			return plccWiring();
+#else
+			return defaultWiring();
+#endif
+		}
+
+		Wiring wiring = builtWiring();
+		uint8_t dots[8][32][32];           // by ADDR, COL and ROW lines
+		unsigned long low_pulses = 0;      // ENABLE low pulses, two per strobe
+		unsigned long bad_data = 0;        // pulses with both or neither row driver on
+		unsigned long line_changes = 0;    // ADDR, COL, ROW and data pins that changed
+		unsigned long min_low_us = 0;      // shortest and longest ENABLE low pulse
+		unsigned long max_low_us = 0;
+		void (*on_enable)(uint8_t level) = NULL;  // called on every ENABLE edge
+
+		// Blank panels, listening to the pins
+		void begin(Wiring w = builtWiring()) {
+			*this = PanelSim();
+			wiring = w;
+			simIO().listener = _listener;
+		}
+
+		unsigned long strobes(void) const { return low_pulses / 2; }
+
+		// Coil address of dot (x, y) on a row of w / pw panels of height h,
+		// mounted as on the wall. The columns of a panel run right to left
+		// from its right edge, the rows bottom to top and 3 lower, and every
+		// eighth address line is not wired to a coil.
+		static void address(int x, int y, int w, int h, int pw, int& panel, int& col, int& row) {
+			const int c = w - x % pw - 1;
+			const int r = h - y - 1 + 3;
+			panel = x / pw;
+			col = (c + 1 + c / 7) & 31;
+			row = (r + r / 7) & 31;
+		}
+
+		int dot(int x, int y, int w, int h, int pw) const {
+			int panel, col, row;
+			address(x, y, w, h, pw, panel, col, row);
+			return dots[panel][col][row];
+		}
+
+		// Dots of the panels that differ from the display's frame
+		int mismatches(BROSE9323& d, int pw = 28) const {
+			int bad = 0;
+			for (int y = 0; y < d.height(); y++) {
+				for (int x = 0; x < d.width(); x++) {
+					if (dot(x, y, d.width(), d.height(), pw) != d.getBufferPixel(x, y)) bad++;
+				}
+			}
+			return bad;
+		}
+
+	private:
+		unsigned long _fall_us = 0;
+
+		static bool _isLine(const Wiring& w, uint8_t pin) {
+			for (uint8_t i = 0; i < 5; i++) {
+				if (w.col[i] == pin || w.row[i] == pin || (i < 3 && w.addr[i] == pin)) return true;
+			}
+			return pin == w.col_data || pin == w.row_reset || pin == w.row_set;
+		}
+
+		static uint8_t _read(const uint8_t* pins, uint8_t n) {
+			uint8_t v = 0;
+			for (uint8_t i = 0; i < n; i++) v |= digitalRead(pins[i]) << i;
+			return v;
+		}
+
+		void _enable(uint8_t level) {
+			const unsigned long now = micros();
+			if (!level) {
+				_fall_us = now;
+				low_pulses++;
+				const bool set = !digitalRead(wiring.row_set) && digitalRead(wiring.row_reset) && !digitalRead(wiring.col_data);
+				const bool reset = digitalRead(wiring.row_set) && !digitalRead(wiring.row_reset) && digitalRead(wiring.col_data);
+				if (set == reset) {
+					bad_data++;
+				} else {
+					dots[_read(wiring.addr, 3)][_read(wiring.col, 5)][_read(wiring.row, 5)] = set;
+				}
+			} else if (low_pulses) {
+				const unsigned long width = now - _fall_us;
+				if (low_pulses == 1 || width < min_low_us) min_low_us = width;
+				if (width > max_low_us) max_low_us = width;
+			}
+			if (on_enable) on_enable(level);
+		}
+
+		static void _listener(uint8_t pin, uint8_t level);
+};
+
+inline PanelSim& panelSim(void) {
+	static PanelSim panel;
+	return panel;
+}
+
+inline void PanelSim::_listener(uint8_t pin, uint8_t level) {
+	PanelSim& p = panelSim();
+	if (pin == p.wiring.enable) {
+		p._enable(level);
+	} else if (_isLine(p.wiring, pin)) {
+		p.line_changes++;
+	}
+}
+
+// Shows the display's frame on the panels. With the flip engine display()
+// only hands the frame over, its ticks are run here until it is done.
+inline void simShow(BROSE9323& d, bool force = false) {
+	d.display(force);
+#ifdef BROSE9323_ASYNC
+	while (d.busy()) simAdvance(d.tick());
+#endif
+}
+
+#endif //PANEL_SIM_H
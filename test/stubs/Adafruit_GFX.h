@@ -0,0 +1,206 @@
+#ifndef _ADAFRUIT_GFX_H
+#define _ADAFRUIT_GFX_H
+
+// Stand-in for the Adafruit GFX library in the host tests. The shapes go
+// through drawPixel() and the write*() calls the way the library's own
+// fallbacks do, so a display that overrides some of them is tested against
+// the rest. Text uses the library's 6x8 cell, the glyphs are made up: any
+// shape does for the tests, as long as a character always looks the same.
+
+#include <Arduino.h>
+
+// Column i (0-4) of a glyph, bit 0 is the top row
+inline uint8_t simGlyphColumn(unsigned char c, uint8_t i) {
+	uint32_t h = (c + 1) * 2654435761u + i * 40503u;
+	h ^= h >> 15;
+	return (h * 2246822519u) >> 24;
+}
+
+class Adafruit_GFX : public Print {
+	protected:
+		int16_t WIDTH, HEIGHT;
+		int16_t _width, _height;
+		int16_t cursor_x = 0, cursor_y = 0;
+		uint16_t textcolor = 0xFFFF, textbgcolor = 0xFFFF;
+		uint8_t textsize_x = 1, textsize_y = 1;
+		uint8_t rotation = 0;
+		bool wrap = true;
+		bool _cp437 = false;
+	public:
+		Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+		virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+		virtual void startWrite(void) {}
+		virtual void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+		virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { fillRect(x, y, w, h, color); }
+		virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); }
+		virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { drawFastHLine(x, y, w, color); }
+		virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+			const bool steep = abs(y1 - y0) > abs(x1 - x0);
+			int16_t t;
+			if (steep) {
+				t = x0; x0 = y0; y0 = t;
+				t = x1; x1 = y1; y1 = t;
+			}
+			if (x0 > x1) {
+				t = x0; x0 = x1; x1 = t;
+				t = y0; y0 = y1; y1 = t;
+			}
+			const int16_t dx = x1 - x0;
+			const int16_t dy = abs(y1 - y0);
+			const int16_t ystep = y0 < y1 ? 1 : -1;
+			int16_t err = dx / 2;
+			for (; x0 <= x1; x0++) {
+				if (steep) {
+					writePixel(y0, x0, color);
+				} else {
+					writePixel(x0, y0, color);
+				}
+				err -= dy;
+				if (err < 0) {
+					y0 += ystep;
+					err += dx;
+				}
+			}
+		}
+		virtual void endWrite(void) {}
+
+		virtual void setRotation(uint8_t r) {
+			rotation = r & 3;
+			_width = rotation & 1 ? HEIGHT : WIDTH;
+			_height = rotation & 1 ? WIDTH : HEIGHT;
+		}
+		virtual void invertDisplay(bool) {}
+
+		virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+			startWrite();
+			writeLine(x, y, x, y + h - 1, color);
+			endWrite();
+		}
+		virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+			startWrite();
+			writeLine(x, y, x + w - 1, y, color);
+			endWrite();
+		}
+		virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+			startWrite();
+			for (int16_t i = x; i < x + w; i++) writeFastVLine(i, y, h, color);
+			endWrite();
+		}
+		virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+		virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+			if (x0 == x1) {
+				if (y0 > y1) { int16_t t = y0; y0 = y1; y1 = t; }
+				drawFastVLine(x0, y0, y1 - y0 + 1, color);
+			} else if (y0 == y1) {
+				if (x0 > x1) { int16_t t = x0; x0 = x1; x1 = t; }
+				drawFastHLine(x0, y0, x1 - x0 + 1, color);
+			} else {
+				startWrite();
+				writeLine(x0, y0, x1, y1, color);
+				endWrite();
+			}
+		}
+		virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+			startWrite();
+			writeFastHLine(x, y, w, color);
+			writeFastHLine(x, y + h - 1, w, color);
+			writeFastVLine(x, y, h, color);
+			writeFastVLine(x + w - 1, y, h, color);
+			endWrite();
+		}
+
+		void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+			for (int16_t y = -r; y <= r; y++) {
+				for (int16_t x = -r; x <= r; x++) {
+					const int16_t d = x * x + y * y;
+					if (d <= r * r && d > (r - 1) * (r - 1)) drawPixel(x0 + x, y0 + y, color);
+				}
+			}
+		}
+		void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+			for (int16_t y = -r; y <= r; y++) {
+				for (int16_t x = -r; x <= r; x++) {
+					if (x * x + y * y <= r * r) drawPixel(x0 + x, y0 + y, color);
+				}
+			}
+		}
+
+		void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) {
+			const int16_t byte_width = (w + 7) / 8;
+			startWrite();
+			for (int16_t j = 0; j < h; j++) {
+				for (int16_t i = 0; i < w; i++) {
+					if (pgm_read_byte(&bitmap[j * byte_width + i / 8]) & (0x80 >> (i & 7))) writePixel(x + i, y + j, color);
+				}
+			}
+			endWrite();
+		}
+		void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg) {
+			const int16_t byte_width = (w + 7) / 8;
+			startWrite();
+			for (int16_t j = 0; j < h; j++) {
+				for (int16_t i = 0; i < w; i++) {
+					writePixel(x + i, y + j, pgm_read_byte(&bitmap[j * byte_width + i / 8]) & (0x80 >> (i & 7)) ? color : bg);
+				}
+			}
+			endWrite();
+		}
+		void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color) {
+			drawBitmap(x, y, (const uint8_t*)bitmap, w, h, color);
+		}
+		void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg) {
+			drawBitmap(x, y, (const uint8_t*)bitmap, w, h, color, bg);
+		}
+
+		void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+			if (!_cp437 && c >= 176) c++;
+			startWrite();
+			for (int8_t i = 0; i < 5; i++) {
+				uint8_t line = simGlyphColumn(c, i);
+				for (int8_t j = 0; j < 8; j++, line >>= 1) {
+					if (line & 1) {
+						if (size == 1) writePixel(x + i, y + j, color); else writeFillRect(x + i * size, y + j * size, size, size, color);
+					} else if (bg != color) {
+						if (size == 1) writePixel(x + i, y + j, bg); else writeFillRect(x + i * size, y + j * size, size, size, bg);
+					}
+				}
+			}
+			if (bg != color) {
+				if (size == 1) writeFastVLine(x + 5, y, 8, bg); else writeFillRect(x + 5 * size, y, size, 8 * size, bg);
+			}
+			endWrite();
+		}
+
+		size_t write(uint8_t c) {
+			if (c == '\n') {
+				cursor_x = 0;
+				cursor_y += textsize_y * 8;
+			} else if (c != '\r') {
+				if (wrap && cursor_x + textsize_x * 6 > _width) {
+					cursor_x = 0;
+					cursor_y += textsize_y * 8;
+				}
+				drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x);
+				cursor_x += textsize_x * 6;
+			}
+			return 1;
+		}
+		using Print::write;
+
+		void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+		void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+		void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+		void setTextSize(uint8_t s) { textsize_x = textsize_y = s > 0 ? s : 1; }
+		void setTextWrap(bool w) { wrap = w; }
+		void cp437(bool x = true) { _cp437 = x; }
+
+		int16_t width(void) const { return _width; }
+		int16_t height(void) const { return _height; }
+		uint8_t getRotation(void) const { return rotation; }
+		int16_t getCursorX(void) const { return cursor_x; }
+		int16_t getCursorY(void) const { return cursor_y; }
+};
+
+#endif // _ADAFRUIT_GFX_H
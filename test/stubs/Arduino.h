@@ -0,0 +1,326 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Stand-in for the Arduino core in the host tests (the test environments in
+// platformio.ini). Pins D0-D13 and A0-A5 live in three mock port registers
+// laid out as on the ATmega328P, so digitalWrite() and the driver's port
+// register backend change the same bits. Time only moves when the code
+// waits in delay(), delayMicroseconds() or yield(), or when a test calls
+// simAdvance(). Serial is an in-memory stream.
+//
+// Everything is inline, the driver sources and a test share one simulation
+// without a library of their own.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#define HIGH 1
+#define LOW  0
+
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_ptr(addr)  (*(void* const*)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+#define _BV(bit) (1 << (bit))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+static const uint8_t A0 = 14, A1 = 15, A2 = 16, A3 = 17, A4 = 18, A5 = 19;
+
+#define SIM_PINS 20
+
+template <class T, class L>
+inline auto min(const T& a, const L& b) -> decltype(b < a ? b : a) {
+	return b < a ? b : a;
+}
+
+template <class T, class L>
+inline auto max(const T& a, const L& b) -> decltype(b < a ? b : a) {
+	return a < b ? b : a;
+}
+
+#define constrain(x, low, high) ((x) < (low) ? (low) : ((x) > (high) ? (high) : (x)))
+
+// An I/O port register. A write changes the levels of its pins at once and
+// then reports every pin that changed to simIO().listener.
+class SimPort {
+	private:
+		const uint8_t _first_pin;  // Arduino pin of bit 0
+		const uint8_t _pins;
+		uint8_t _value = 0;
+	public:
+		SimPort(uint8_t first_pin, uint8_t pins) : _first_pin(first_pin), _pins(pins) {}
+
+		operator uint8_t() const { return _value; }
+		SimPort& operator=(uint8_t value);
+		SimPort& operator|=(uint8_t bits) { return *this = _value | bits; }
+		SimPort& operator&=(uint8_t bits) { return *this = _value & bits; }
+		SimPort& operator=(const SimPort& port) { return *this = (uint8_t)port; }
+
+		// Arduino pin of a bit, or SIM_PINS if the port has no such pin
+		uint8_t pin(uint8_t bit) const { return bit < _pins ? _first_pin + bit : SIM_PINS; }
+};
+
+struct SimIO {
+	SimPort port_b{8, 6};   // D8-D13
+	SimPort port_c{14, 6};  // A0-A5
+	SimPort port_d{0, 8};   // D0-D7
+	uint8_t sreg = 0;
+	uint8_t modes[SIM_PINS] = {};
+	unsigned long us = 0;
+	uint32_t random_state = 1;
+	void (*listener)(uint8_t pin, uint8_t level) = NULL;
+	void (*interrupts[2])(void) = {NULL, NULL};
+};
+
+inline SimIO& simIO(void) {
+	static SimIO io;
+	return io;
+}
+
+// The mock registers. The host has no PORTB, the test environments point
+// the driver's BROSE9323_PORTx hooks (BROSE9323_io.h) at these.
+#define SIM_PORTB (simIO().port_b)
+#define SIM_PORTC (simIO().port_c)
+#define SIM_PORTD (simIO().port_d)
+#define SREG      (simIO().sreg)
+
+inline SimPort& simPort(uint8_t pin) {
+	return pin < 8 ? SIM_PORTD : pin < 14 ? SIM_PORTB : SIM_PORTC;
+}
+
+inline uint8_t simBit(uint8_t pin) {
+	return pin < 8 ? pin : pin < 14 ? pin - 8 : pin - 14;
+}
+
+inline SimPort& SimPort::operator=(uint8_t value) {
+	const uint8_t changed = (_value ^ value) & ((1 << _pins) - 1);
+	_value = value;
+	for (uint8_t bit = 0; bit < _pins; bit++) {
+		if ((changed & (1 << bit)) && simIO().listener) simIO().listener(pin(bit), (value >> bit) & 1);
+	}
+	return *this;
+}
+
+// Level of every pin, bit n for pin n
+inline uint32_t simPinLevels(void) {
+	return (uint32_t)(uint8_t)SIM_PORTD | (uint32_t)((uint8_t)SIM_PORTB & 0x3F) << 8 |
+		(uint32_t)((uint8_t)SIM_PORTC & 0x3F) << 14;
+}
+
+// Drives an input from outside, as a microphone would. A pin interrupt
+// attached to it runs.
+inline void simSetPin(uint8_t pin, uint8_t level);
+
+inline void simAdvance(unsigned long us) {
+	simIO().us += us;
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+	if (pin < SIM_PINS) simIO().modes[pin] = mode;
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t level) {
+	if (pin >= SIM_PINS) return;
+	SimPort& port = simPort(pin);
+	if (level) {
+		port |= 1 << simBit(pin);
+	} else {
+		port &= ~(1 << simBit(pin));
+	}
+}
+
+inline int digitalRead(uint8_t pin) {
+	return pin < SIM_PINS ? ((uint8_t)simPort(pin) >> simBit(pin)) & 1 : LOW;
+}
+
+inline int analogRead(uint8_t) {
+	return 0;
+}
+
+#define digitalPinToInterrupt(pin) ((pin) == 2 ? 0 : (pin) == 3 ? 1 : -1)
+
+inline void attachInterrupt(int8_t interrupt, void (*isr)(void), int) {
+	if (interrupt == 0 || interrupt == 1) simIO().interrupts[interrupt] = isr;
+}
+
+inline void detachInterrupt(int8_t interrupt) {
+	if (interrupt == 0 || interrupt == 1) simIO().interrupts[interrupt] = NULL;
+}
+
+inline void simSetPin(uint8_t pin, uint8_t level) {
+	if (digitalRead(pin) == !!level) return;
+	digitalWrite(pin, level);
+	const int8_t interrupt = digitalPinToInterrupt(pin);
+	if (interrupt >= 0 && simIO().interrupts[interrupt]) simIO().interrupts[interrupt]();
+}
+
+inline void cli(void) {}
+inline void sei(void) {}
+inline void noInterrupts(void) {}
+inline void interrupts(void) {}
+// Loops that wait with yield() let a millisecond pass each time, so their
+// timeouts run out
+inline void yield(void) {
+	simIO().us += 1000;
+}
+
+inline unsigned long micros(void) {
+	return simIO().us;
+}
+
+inline unsigned long millis(void) {
+	return simIO().us / 1000;
+}
+
+inline void delayMicroseconds(unsigned int us) {
+	simIO().us += us;
+}
+
+inline void delay(unsigned long ms) {
+	simIO().us += ms * 1000;
+}
+
+inline void randomSeed(unsigned long seed) {
+	simIO().random_state = seed ? seed : 1;
+}
+
+// xorshift32, the same sequence on every host
+inline long random(long howbig) {
+	if (howbig <= 0) return 0;
+	uint32_t& s = simIO().random_state;
+	s ^= s << 13;
+	s ^= s >> 17;
+	s ^= s << 5;
+	return s % howbig;
+}
+
+inline long random(long howsmall, long howbig) {
+	return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+	return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+class Print {
+	private:
+		size_t _number(unsigned long n, int base) {
+			char digits[33];
+			char* p = digits + sizeof(digits);
+			*--p = 0;
+			if (base < 2) base = 10;
+			do {
+				const int d = n % base;
+				*--p = d < 10 ? '0' + d : 'A' + d - 10;
+				n /= base;
+			} while (n);
+			return write(p);
+		}
+	public:
+		virtual ~Print() {}
+		virtual size_t write(uint8_t) = 0;
+		virtual size_t write(const uint8_t* buffer, size_t size) {
+			size_t n = 0;
+			while (size--) n += write(*buffer++);
+			return n;
+		}
+		size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+		size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+		virtual void flush(void) {}
+
+		size_t print(const char* s) { return write(s); }
+		size_t print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+		size_t print(const std::string& s) { return write(s.c_str()); }
+		size_t print(char c) { return write((uint8_t)c); }
+		size_t print(unsigned char n, int base = 10) { return _number(n, base); }
+		size_t print(int n, int base = 10) { return print((long)n, base); }
+		size_t print(unsigned int n, int base = 10) { return _number(n, base); }
+		size_t print(long n, int base = 10) {
+			if (base == 10 && n < 0) return write('-') + _number(-(unsigned long)n, 10);
+			return _number(n, base);
+		}
+		size_t print(unsigned long n, int base = 10) { return _number(n, base); }
+		size_t print(double n, int digits = 2) {
+			char s[32];
+			snprintf(s, sizeof(s), "%.*f", digits, n);
+			return write(s);
+		}
+
+		size_t println(void) { return write("\r\n"); }
+		template <class T>
+		size_t println(const T& value) { return print(value) + println(); }
+		template <class T>
+		size_t println(const T& value, int format) { return print(value, format) + println(); }
+};
+
+class Stream : public Print {
+	public:
+		virtual int available(void) = 0;
+		virtual int read(void) = 0;
+		virtual int peek(void) = 0;
+};
+
+// Serial: bytes the test queues with input are read back, everything
+// written is collected in output
+class HardwareSerial : public Stream {
+	public:
+		std::string input;
+		std::string output;
+
+		void begin(unsigned long) {}
+		void end(void) {}
+		int available(void) { return input.size(); }
+		int read(void) {
+			if (input.empty()) return -1;
+			const uint8_t c = input[0];
+			input.erase(0, 1);
+			return c;
+		}
+		int peek(void) { return input.empty() ? -1 : (uint8_t)input[0]; }
+		int availableForWrite(void) { return 64; }
+		size_t write(uint8_t c) {
+			output += (char)c;
+			return 1;
+		}
+		using Print::write;
+		operator bool() const { return true; }
+};
+
+inline HardwareSerial& simSerial(void) {
+	static HardwareSerial serial;
+	return serial;
+}
+
+// Back to power-on: all pins low, time 0, no listener, nothing on Serial
+inline void simReset(void) {
+	simIO().listener = NULL;
+	simIO() = SimIO();
+	simSerial().input.clear();
+	simSerial().output.clear();
+}
+
+#define Serial (simSerial())
+
+#endif //ARDUINO_H
@@ -0,0 +1,118 @@
+// The coil address tables BROSE9323Fixed generates at compile time have to
+// hold what the address arithmetic gives for every column and row, with
+// and without mirroring, and the panels have to show the frame.
+
+#include <unity.h>
+#include <PanelSim.h>
+
+#include <vector>
+
+void setUp(void) {
+	simReset();
+	panelSim().begin();
+}
+
+void tearDown(void) {
+}
+
+// Every entry against PanelSim::address(), the panel in bits 5-7 of a
+// column entry
+template <uint8_t W, uint8_t H, uint8_t PANEL_W, uint8_t FLAGS>
+static void checkTable(void) {
+	typedef BROSE9323AddressTable<W, H, PANEL_W, FLAGS> Table;
+	char message[64];
+	for (int x = 0; x < W; x++) {
+		int panel, col, row;
+		PanelSim::address(FLAGS & BROSE9323::MIRROR_X ? W - 1 - x : x, 0, W, H, PANEL_W, panel, col, row);
+		snprintf(message, sizeof(message), "%dx%d/%d flags %d column %d", W, H, PANEL_W, FLAGS, x);
+		TEST_ASSERT_EQUAL_MESSAGE(panel << 5 | col, pgm_read_byte(&Table::columns[x]), message);
+	}
+	for (int y = 0; y < H; y++) {
+		int panel, col, row;
+		PanelSim::address(0, FLAGS & BROSE9323::MIRROR_Y ? H - 1 - y : y, W, H, PANEL_W, panel, col, row);
+		snprintf(message, sizeof(message), "%dx%d/%d flags %d row %d", W, H, PANEL_W, FLAGS, y);
+		TEST_ASSERT_EQUAL_MESSAGE(row, pgm_read_byte(&Table::rows[y]), message);
+	}
+}
+
+static void test_tables(void) {
+	checkTable<84, 16, 28, 0>();
+	checkTable<84, 16, 28, BROSE9323::MIRROR_X>();
+	checkTable<84, 16, 28, BROSE9323::MIRROR_Y>();
+	checkTable<84, 16, 28, BROSE9323::ROTATE_180>();
+	checkTable<28, 16, 28, 0>();
+	checkTable<56, 7, 28, BROSE9323::MIRROR_X>();
+	checkTable<200, 25, 28, BROSE9323::MIRROR_Y>();
+	checkTable<224, 24, 28, BROSE9323::ROTATE_180>();
+}
+
+template <uint8_t FLAGS>
+static void showRandomFrames(void) {
+	BROSE9323Fixed<84, 16, 28, FLAGS> d;
+	d.begin();
+	d.fillScreen(0);
+	simShow(d, true);
+	randomSeed(4);
+	for (uint8_t f = 0; f < 50; f++) {
+		for (uint8_t i = 0; i < 100; i++) d.drawPixel(random(84), random(16), random(2));
+		simShow(d);
+		for (int y = 0; y < 16; y++) {
+			for (int x = 0; x < 84; x++) {
+				const int px = FLAGS & BROSE9323::MIRROR_X ? 83 - x : x;
+				const int py = FLAGS & BROSE9323::MIRROR_Y ? 15 - y : y;
+				TEST_ASSERT_EQUAL(d.getBufferPixel(x, y), panelSim().dot(px, py, 84, 16, 28));
+			}
+		}
+	}
+	TEST_ASSERT_EQUAL(0, panelSim().bad_data);
+}
+
+static void test_panels_as_wired(void) {
+	showRandomFrames<0>();
+}
+
+static void test_panels_rotated(void) {
+	showRandomFrames<BROSE9323::ROTATE_180>();
+}
+
+// A display sized at run time has no tables and computes the addresses,
+// it has to drive the pins the same way
+static std::vector<uint32_t> _levels;
+
+static void _record(uint8_t) {
+	_levels.push_back(simPinLevels());
+}
+
+static std::vector<uint32_t> trace(BROSE9323& d) {
+	simReset();
+	panelSim().begin();
+	panelSim().on_enable = _record;
+	_levels.clear();
+	d.begin();
+	d.fillScreen(0);
+	simShow(d, true);
+	randomSeed(5);
+	for (uint8_t f = 0; f < 20; f++) {
+		for (uint8_t i = 0; i < 100; i++) d.drawPixel(random(84), random(16), random(2));
+		simShow(d);
+	}
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(d));
+	return _levels;
+}
+
+static void test_same_as_runtime(void) {
+	BROSE9323Fixed<84, 16, 28> fixed;
+	BROSE9323 runtime(84, 16, 28);
+	const std::vector<uint32_t> expected = trace(runtime);
+	TEST_ASSERT_GREATER_THAN(1000, expected.size());
+	TEST_ASSERT_TRUE(trace(fixed) == expected);
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_tables);
+	RUN_TEST(test_panels_as_wired);
+	RUN_TEST(test_panels_rotated);
+	RUN_TEST(test_same_as_runtime);
+	return UNITY_END();
+}
@@ -0,0 +1,180 @@
+// Animations encoded as flipanim does (src/host/AnimationEncoder.h) have to
+// play back frame by frame with their durations on the display, with the
+// panels showing every frame, whether the frames are key frames or deltas.
+// The bounce animation main.cpp plays has to loop seamlessly.
+
+#include <unity.h>
+#include <PanelSim.h>
+
+#include <Animation.h>
+#include <host/AnimationEncoder.h>
+#include <host/HostCanvas.h>
+#include <animations/bounce.h>
+
+#include <vector>
+
+typedef BROSE9323Fixed<84, 16, 28> Display;
+typedef std::vector<std::vector<uint8_t> > Frames;
+
+// Strobes to flip dots that changed in columns. Without an old buffer
+// (ATmega168) the columns the player marks dirty are walked whole.
+#if BROSE9323_OLD_FRAMES
+#define STROBES(dots, columns) (dots)
+#else
+#define STROBES(dots, columns) (16 * (columns))
+#endif
+
+static Display* display;
+
+void setUp(void) {
+	simReset();
+	panelSim().begin();
+	display = new Display;
+	display->begin();
+	display->fillScreen(0);
+	simShow(*display, true);
+}
+
+void tearDown(void) {
+	delete display;
+}
+
+// A frame of column words with the dots of dot(x, y) set
+template <typename F> static std::vector<uint8_t> frame(uint8_t w, uint8_t h, F dot) {
+	const uint8_t column_size = (h + 7) / 8;
+	std::vector<uint8_t> words(w * column_size);
+	for (uint8_t x = 0; x < w; x++) {
+		for (uint8_t y = 0; y < h; y++) {
+			if (dot(x, y)) words[x * column_size + y / 8] |= 1 << (y & 7);
+		}
+	}
+	return words;
+}
+
+// A sprite moving over noise that changes a little each frame, then an
+// inverted frame and a blank one
+static Frames makeFrames(uint8_t w, uint8_t h, int count) {
+	Frames frames;
+	randomSeed(5);
+	std::vector<uint8_t> noise(w * h);
+	for (size_t i = 0; i < noise.size(); i++) noise[i] = random(8) == 0;
+	for (int n = 0; n < count; n++) {
+		for (uint8_t i = 0; i < 5; i++) noise[random(noise.size())] ^= 1;
+		frames.push_back(frame(w, h, [&](uint8_t x, uint8_t y) {
+			return noise[y * w + x] || ((x - n) % w < 4 && (y + n) % h < 4);
+		}));
+	}
+	frames.push_back(frame(w, h, [&](uint8_t x, uint8_t y) { return !noise[y * w + x]; }));
+	frames.push_back(frame(w, h, [](uint8_t, uint8_t) { return false; }));
+	return frames;
+}
+
+static std::vector<uint16_t> makeDurations(size_t count) {
+	std::vector<uint16_t> durations;
+	for (size_t n = 0; n < count; n++) durations.push_back(20 + 10 * (n % 7));
+	return durations;
+}
+
+// Plays an animation once, every frame has to reach the panels
+static void play(const std::vector<uint8_t>& animation, const Frames& frames, const std::vector<uint16_t>& durations) {
+	AnimationEffect<Display> effect(*display, "test", animation.data(), false);
+	effect.begin();
+	for (size_t n = 0; n < frames.size(); n++) {
+		char message[32];
+		snprintf(message, sizeof(message), "frame %u", (unsigned)n);
+		TEST_ASSERT_EQUAL_MESSAGE(durations[n], effect.frameMs(), message);
+		TEST_ASSERT_EQUAL_MESSAGE(n + 1 < frames.size(), effect.tick(0), message);
+		simShow(*display);
+		for (uint8_t x = 0; x < 84; x++) {
+			TEST_ASSERT_EQUAL_UINT8_MESSAGE(frames[n][2 * x], display->getColumnByte(x, 0), message);
+			TEST_ASSERT_EQUAL_UINT8_MESSAGE(frames[n][2 * x + 1], display->getColumnByte(x, 1), message);
+		}
+		TEST_ASSERT_EQUAL_MESSAGE(0, panelSim().mismatches(*display), message);
+	}
+}
+
+static void test_deltas(void) {
+	const Frames frames = makeFrames(84, 16, 40);
+	const std::vector<uint16_t> durations = makeDurations(frames.size());
+	int keys;
+	const std::vector<uint8_t> animation = animationEncode(84, 16, frames, durations, 0, &keys);
+	TEST_ASSERT_LESS_THAN((int)frames.size(), keys);
+	play(animation, frames, durations);
+}
+
+static void test_key_frames(void) {
+	const Frames frames = makeFrames(84, 16, 40);
+	const std::vector<uint16_t> durations = makeDurations(frames.size());
+	int keys;
+	const std::vector<uint8_t> animation = animationEncode(84, 16, frames, durations, 1, &keys);
+	TEST_ASSERT_EQUAL((int)frames.size(), keys);
+	play(animation, frames, durations);
+}
+
+// Only the columns a frame changes are flipped
+static void test_changed_columns_only(void) {
+	Frames frames;
+	frames.push_back(frame(84, 16, [](uint8_t x, uint8_t y) { return x == 10 && y < 4; }));
+	frames.push_back(frame(84, 16, [](uint8_t x, uint8_t y) { return x == 11 && y < 4; }));
+	const std::vector<uint16_t> durations = makeDurations(2);
+	const std::vector<uint8_t> animation = animationEncode(84, 16, frames, durations);
+	AnimationEffect<Display> effect(*display, "test", animation.data(), false);
+	effect.begin();
+	unsigned long strobes = panelSim().strobes();
+	effect.tick(0);
+	simShow(*display);
+	TEST_ASSERT_EQUAL(STROBES(4, 1), panelSim().strobes() - strobes);
+	strobes = panelSim().strobes();
+	effect.tick(0);
+	simShow(*display);
+	TEST_ASSERT_EQUAL(STROBES(8, 2), panelSim().strobes() - strobes);
+}
+
+// An animation of another size shows nothing
+static void test_other_size(void) {
+	const Frames frames = makeFrames(29, 12, 5);
+	const std::vector<uint8_t> animation = animationEncode(29, 12, frames, makeDurations(frames.size()));
+	AnimationEffect<Display> effect(*display, "test", animation.data());
+	effect.begin();
+	TEST_ASSERT_FALSE(effect.tick(0));
+	TEST_ASSERT_EQUAL(0, display->pending());
+
+	HostCanvas canvas(29, 12);
+	AnimationEffect<HostCanvas> host(canvas, "test", animation.data(), false);
+	host.begin();
+	for (size_t n = 0; n < frames.size(); n++) {
+		host.tick(0);
+		for (uint8_t x = 0; x < 29; x++) {
+			TEST_ASSERT_EQUAL_UINT8(frames[n][2 * x], canvas.getColumnByte(x, 0));
+			TEST_ASSERT_EQUAL_UINT8(frames[n][2 * x + 1], canvas.getColumnByte(x, 1));
+		}
+	}
+}
+
+// The shipped animation plays twice around. It loops seamlessly: from its
+// last frame back to the first the ball moves one dot, as between any
+// other two frames.
+static void test_bounce(void) {
+	const uint16_t count = pgm_read_byte(bounceAnimation + 2) | pgm_read_byte(bounceAnimation + 3) << 8;
+	AnimationEffect<Display> effect(*display, "bounce", bounceAnimation);
+	effect.begin();
+	for (uint16_t n = 0; n < 2 * count; n++) {
+		TEST_ASSERT_EQUAL(60, effect.frameMs());
+		TEST_ASSERT_TRUE(effect.tick(0));
+		const unsigned long strobes = panelSim().strobes();
+		simShow(*display);
+		TEST_ASSERT_EQUAL(0, panelSim().mismatches(*display));
+		// A ball of 13 dots, 5 columns wide, moved diagonally by one
+		if (n > 0) TEST_ASSERT_LESS_OR_EQUAL(STROBES(10, 6), panelSim().strobes() - strobes);
+	}
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_deltas);
+	RUN_TEST(test_key_frames);
+	RUN_TEST(test_changed_columns_only);
+	RUN_TEST(test_other_size);
+	RUN_TEST(test_bounce);
+	return UNITY_END();
+}
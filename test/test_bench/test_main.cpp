@@ -0,0 +1,105 @@
+// Per-effect benchmark: runs every effect of src/main.cpp on the simulated
+// panels and reports, per frame, the strobes, the ADDR/COL/ROW/data line
+// changes, the time the panel needs for them at the flip time, and the host
+// CPU time of display(). A baseline to compare driver changes against:
+//
+//   pio test -e test -f test_bench -v
+//
+// It also checks that the panels show every frame.
+
+#include <chrono>
+
+#include <unity.h>
+#include <PanelSim.h>
+
+#include "../../src/main.cpp"
+
+#define BENCH_FRAMES 200
+
+// sound without a microphone, as with SoundEffect(true)
+SoundEffect simulatedSound(true);
+
+void setUp(void) {
+	simReset();
+	panelSim().begin();
+	display.begin();
+	display.fillScreen(0);
+	simShow(display, true);
+}
+
+void tearDown(void) {
+}
+
+static void bench(Effect& effect) {
+	EffectRandom::seed(1);
+	randomSeed(1);
+	effect.begin();
+	const unsigned long strobes = panelSim().strobes();
+	const unsigned long lines = panelSim().line_changes;
+	const unsigned long start_us = micros();
+	double cpu_ns = 0;
+	int bad_frames = 0;
+	for (int f = 0; f < BENCH_FRAMES; f++) {
+		effect.tick(millis());
+		const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		simShow(display);
+		cpu_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+		if (panelSim().mismatches(display)) bad_frames++;
+	}
+
+	char line[128];
+	snprintf(line, sizeof(line), "%-14s %8.1f strobes %8.1f line changes %8.2f ms panel %8.0f ns display()",
+		effect.name(),
+		(double)(panelSim().strobes() - strobes) / BENCH_FRAMES,
+		(double)(panelSim().line_changes - lines) / BENCH_FRAMES,
+		(micros() - start_us) / 1000.0 / BENCH_FRAMES,
+		cpu_ns / BENCH_FRAMES);
+	TEST_MESSAGE(line);
+	TEST_ASSERT_EQUAL_MESSAGE(0, bad_frames, effect.name());
+	TEST_ASSERT_EQUAL(0, panelSim().bad_data);
+}
+
+static void test_effects(void) {
+	for (uint8_t i = 0; i < sizeof(effects) / sizeof(effects[0]); i++) {
+		bench(effects[i] == &soundEffect ? simulatedSound : *effects[i]);
+	}
+}
+
+// Strobes are ENABLE low for the flip time, high for twice that and low
+// again, the low pulses must not be cut short
+static void test_pulse_width(void) {
+	RandomFlipEffect<Display> effect(display);
+	bench(effect);
+	TEST_ASSERT_EQUAL(display.getTiming(), panelSim().min_low_us);
+	TEST_ASSERT_EQUAL(display.getTiming(), panelSim().max_low_us);
+}
+
+// Drops have to fall all the way down a display taller than 127 rows
+struct TallCanvas : Adafruit_GFX {
+	unsigned long low_dots = 0;  // dots drawn in the bottom 50 rows
+
+	TallCanvas() : Adafruit_GFX(32, 200) {}
+	void drawPixel(int16_t, int16_t y, uint16_t) {
+		if (y >= 150) low_dots++;
+	}
+	void fillScreen(uint16_t) {}
+	void drawFastHLine(int16_t, int16_t, int16_t, uint16_t) {}
+};
+
+static void test_tall_matrix(void) {
+	TallCanvas canvas;
+	MatrixEffect<TallCanvas> effect(canvas);
+	EffectRandom::seed(1);
+	effect.begin();
+	for (int f = 0; f < 300; f++) effect.tick(0);
+	// The sparkles alone are at most 3 a frame
+	TEST_ASSERT_GREATER_THAN(3 * 300, canvas.low_dots);
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_effects);
+	RUN_TEST(test_pulse_width);
+	RUN_TEST(test_tall_matrix);
+	return UNITY_END();
+}
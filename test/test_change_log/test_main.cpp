@@ -0,0 +1,117 @@
+// Few changed dots have to cost few strobes. With an old buffer the walk
+// compares frames; on the ATmega168 (test_168 environment) there is none
+// and the change log has to do it, falling back to whole columns when it
+// overflows. Reports the strobes per frame of each workload and the RAM
+// the display takes:
+//
+//   pio test -e test_168 -f test_change_log -v
+
+#include <unity.h>
+#include <PanelSim.h>
+
+#define W 84
+#define H 16
+
+typedef BROSE9323Fixed<W, H, 28> Display;
+
+static Display* display;
+
+void setUp(void) {
+	simReset();
+	panelSim().begin();
+	display = new Display;
+	display->begin();
+	display->fillScreen(0);
+	simShow(*display, true);
+	randomSeed(9);
+}
+
+void tearDown(void) {
+	delete display;
+}
+
+// Runs frames of a workload, the panels have to show each. Returns the
+// strobes per frame.
+template <typename F> static double run(const char* name, int frames, F draw) {
+	const unsigned long strobes = panelSim().strobes();
+	for (int f = 0; f < frames; f++) {
+		draw(f);
+		simShow(*display);
+		TEST_ASSERT_EQUAL_MESSAGE(0, panelSim().mismatches(*display), name);
+	}
+	const double per_frame = (double)(panelSim().strobes() - strobes) / frames;
+	char line[96];
+	snprintf(line, sizeof(line), "%-24s %7.1f strobes a frame, a full refresh is %d", name, per_frame, W * H);
+	TEST_MESSAGE(line);
+	return per_frame;
+}
+
+static void dots(uint8_t n) {
+	for (uint8_t i = 0; i < n; i++) display->drawPixel(random(W), random(H), random(2));
+}
+
+// At most one strobe per dot drawn, not a column per dot
+static void test_single_dots(void) {
+	TEST_ASSERT_LESS_OR_EQUAL(1.0, run("1 dot", 200, [](int) { dots(1); }));
+	TEST_ASSERT_LESS_OR_EQUAL(5.0, run("5 dots", 200, [](int) { dots(5); }));
+}
+
+static void test_sprite(void) {
+	const double strobes = run("moving 3x3 sprite", 200, [](int f) {
+		display->fillRect((f + 79) % 80, (f + 12) % 13, 3, 3, 0);
+		for (uint8_t j = 0; j < 3; j++) {
+			for (uint8_t i = 0; i < 3; i++) display->drawPixel(f % 80 + i, f % 13 + j, 1);
+		}
+	});
+	TEST_ASSERT_LESS_THAN(6 * H, strobes);
+}
+
+// More dots than the log holds spill into whole columns
+static void test_overflow(void) {
+	run("5-100 dots", 200, [](int) { dots(random(5, 101)); });
+	run("full random redraw", 20, [](int) {
+		for (uint8_t y = 0; y < H; y++) {
+			for (uint8_t x = 0; x < W; x++) display->drawPixel(x, y, random(2));
+		}
+	});
+}
+
+// Dots drawn during a walk are flipped by the next one
+static void test_draw_while_walking(void) {
+	for (uint8_t f = 0; f < 100; f++) {
+		dots(random(1, 40));
+#ifdef BROSE9323_ASYNC
+		display->display();
+		for (uint16_t n = 0; display->busy(); n++) {
+			simAdvance(display->tick());
+#else
+		for (uint16_t n = 0; display->displayStep(); n++) {
+#endif
+			if (n < 40 && random(3) == 0) dots(1);
+			TEST_ASSERT_LESS_THAN(100000, n);
+		}
+		simShow(*display);
+		TEST_ASSERT_EQUAL(0, panelSim().mismatches(*display));
+	}
+}
+
+static void test_ram(void) {
+	char line[96];
+	snprintf(line, sizeof(line), "%dx%d: %d bytes of buffers, %d bytes in all",
+		W, H, (int)BROSE9323_STORAGE_SIZE(W, H), (int)sizeof(Display));
+	TEST_MESSAGE(line);
+#ifdef BROSE9323_CHANGE_LOG
+	// The log has to stay well below the old buffer it replaces
+	TEST_ASSERT_LESS_THAN(BROSE9323_BUFFER_SIZE(W, H) / 2, BROSE9323_CHANGE_LOG * 2 + 2);
+#endif
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_single_dots);
+	RUN_TEST(test_sprite);
+	RUN_TEST(test_overflow);
+	RUN_TEST(test_draw_while_walking);
+	RUN_TEST(test_ram);
+	return UNITY_END();
+}
@@ -0,0 +1,272 @@
+// The column-major frame buffer (BROSE9323_COLUMN_MAJOR) has to hold the
+// same frames as the dots drawn one by one, read back the same row and
+// column bytes and flip just the changed dots, as the row-major one does.
+// Also reports the time planFlips() takes, once per layout:
+//
+//   pio test -e test -e test_column_major -f test_column_major -v
+
+#include <chrono>
+
+#include <unity.h>
+#include <PanelSim.h>
+
+#define W 84
+#define H 16
+
+typedef BROSE9323Fixed<W, H, 28> Display;
+
+void setUp(void) {
+	simReset();
+	panelSim().begin();
+}
+
+void tearDown(void) {
+}
+
+#ifdef BROSE9323_COLUMN_MAJOR
+// The frame as the Adafruit_GFX defaults draw it, dot by dot
+struct RefFrame : Adafruit_GFX {
+	bool dots[H][W];
+
+	RefFrame() : Adafruit_GFX(W, H) {
+		memset(dots, 0, sizeof(dots));
+	}
+
+	void drawPixel(int16_t x, int16_t y, uint16_t color) {
+		if (x >= 0 && x < W && y >= 0 && y < H) dots[y][x] = color;
+	}
+
+	void bitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, int32_t bg) {
+		const int16_t byte_width = (w + 7) / 8;
+		for (int16_t j = 0; j < h; j++) {
+			for (int16_t i = 0; i < w; i++) {
+				if (bitmap[j * byte_width + i / 8] & (0x80 >> (i & 7))) {
+					drawPixel(x + i, y + j, 1);
+				} else if (bg >= 0) {
+					drawPixel(x + i, y + j, bg);
+				}
+			}
+		}
+	}
+
+	void shift(int16_t x, int16_t y, int16_t w, int16_t h, int16_t dx, int16_t dy, bool roll, bool fill) {
+		const int16_t x0 = x < 0 ? 0 : x, y0 = y < 0 ? 0 : y;
+		const int16_t x1 = x + w > W ? W : x + w, y1 = y + h > H ? H : y + h;
+		if (x1 <= x0 || y1 <= y0) return;
+		bool before[H][W];
+		memcpy(before, dots, sizeof(dots));
+		for (int16_t j = y0; j < y1; j++) {
+			for (int16_t i = x0; i < x1; i++) {
+				int32_t si = (int32_t)i - dx, sj = (int32_t)j - dy;
+				if (roll) {
+					si = x0 + ((si - x0) % (x1 - x0) + (x1 - x0)) % (x1 - x0);
+					sj = y0 + ((sj - y0) % (y1 - y0) + (y1 - y0)) % (y1 - y0);
+				}
+				dots[j][i] = si >= x0 && si < x1 && sj >= y0 && sj < y1 ? before[sj][si] : fill;
+			}
+		}
+	}
+};
+
+static unsigned long changed;  // dots that differ from the last frame shown
+
+static void assertSame(Display& d, RefFrame& ref, const bool (&shown)[H][W]) {
+	changed = 0;
+	for (uint8_t y = 0; y < H; y++) {
+		for (uint8_t x = 0; x < W; x++) {
+			char message[32];
+			snprintf(message, sizeof(message), "dot %u, %u", x, y);
+			TEST_ASSERT_EQUAL_MESSAGE(ref.dots[y][x], d.getBufferPixel(x, y), message);
+			changed += ref.dots[y][x] != shown[y][x];
+		}
+	}
+	for (uint16_t i = 0; i < Display::BUFFER_SIZE / 2; i++) {
+		uint8_t bits = 0;
+		for (uint8_t b = 0; b < 8 && (i % 11) * 8 + b < W; b++) bits |= ref.dots[i / 11][(i % 11) * 8 + b] << b;
+		TEST_ASSERT_EQUAL_UINT8(bits, d.getRowByte(i));
+	}
+	for (uint8_t x = 0; x < W; x++) {
+		for (uint8_t i = 0; i < 2; i++) {
+			uint8_t bits = 0;
+			for (uint8_t b = 0; b < 8; b++) bits |= ref.dots[i * 8 + b][x] << b;
+			TEST_ASSERT_EQUAL_UINT8(bits, d.getColumnByte(x, i));
+		}
+	}
+}
+
+// Dots, shapes, bitmaps, text, every kind of scroll, frames written a row
+// byte or a column byte at a time, and a forced refresh. Every frame is
+// compared and shown.
+static void test_same_frames(void) {
+	static Display d;
+	static RefFrame ref;
+	d.begin();
+	d.fillScreen(0);
+	simShow(d, true);
+	bool shown[H][W];
+	memset(shown, 0, sizeof(shown));
+	randomSeed(11);
+	uint8_t bitmap[3 * 12];
+	for (uint8_t f = 0; f < 60; f++) {
+		for (uint8_t i = 0; i < 20; i++) {
+			const int16_t x = random(W), y = random(H);
+			const uint8_t c = random(2);
+			d.drawPixel(x, y, c);
+			ref.drawPixel(x, y, c);
+		}
+		for (uint8_t i = 0; i < sizeof(bitmap); i++) bitmap[i] = random(256);
+		const int16_t x = random(-10, 90), y = random(-6, 18);
+		switch (f % 10) {
+			case 0: {
+				const int16_t w = random(1, 40), h = random(1, 17);
+				const uint8_t c = random(2);
+				d.fillRect(x, y, w, h, c);
+				ref.Adafruit_GFX::fillRect(x, y, w, h, c);
+				break;
+			}
+			case 1:
+				d.drawBitmap(x, y, bitmap, 20, 12, 1);
+				ref.bitmap(x, y, bitmap, 20, 12, -1);
+				break;
+			case 2:
+				d.drawBitmap(x, y, bitmap, 24, 12, 1, 0);
+				ref.bitmap(x, y, bitmap, 24, 12, 0);
+				break;
+			case 3: {
+				const int16_t dx = random(-5, 6), dy = random(-3, 4);
+				const uint8_t fill = random(2);
+				d.scroll(dx, dy, fill);
+				ref.shift(0, 0, W, H, dx, dy, false, fill);
+				break;
+			}
+			case 4: {
+				const int16_t dx = random(-90, 90), dy = random(-20, 20);
+				d.roll(dx, dy);
+				ref.shift(0, 0, W, H, dx, dy, true, 0);
+				break;
+			}
+			case 5: {
+				const int16_t dx = random(-4, 5), dy = random(-4, 5);
+				const uint8_t fill = random(2);
+				d.scrollRect(x, y, 30, 10, dx, dy, fill);
+				ref.shift(x, y, 30, 10, dx, dy, false, fill);
+				break;
+			}
+			case 6: {
+				const int16_t dx = random(-4, 5), dy = random(-4, 5);
+				d.rollRect(x, y, 30, 10, dx, dy);
+				ref.shift(x, y, 30, 10, dx, dy, true, 0);
+				break;
+			}
+			case 7:
+				d.setCursor(x, y);
+				d.setTextColor(1, 0);
+				d.print("9323");
+				ref.setCursor(x, y);
+				ref.setTextColor(1, 0);
+				ref.print("9323");
+				break;
+			case 8:
+				// The last byte of a row holds dots 80-83 only
+				for (uint16_t i = 0; i < 11 * H; i++) {
+					const uint8_t bits = random(256) & (i % 11 == 10 ? 0x0F : 0xFF);
+					d.setRowByte(i, bits);
+					for (uint8_t b = 0; b < 8 && (i % 11) * 8 + b < W; b++) ref.dots[i / 11][(i % 11) * 8 + b] = bits & (1 << b);
+				}
+				d.markDirty(0, W);
+				break;
+			case 9:
+				for (uint8_t c = 0; c < W; c++) {
+					const uint8_t i = random(2), bits = random(256);
+					d.setColumnByte(c, i, bits);
+					for (uint8_t b = 0; b < 8; b++) ref.dots[i * 8 + b][c] = bits & (1 << b);
+				}
+				d.markDirty(0, W);
+				break;
+		}
+		assertSame(d, ref, shown);
+		const bool force = f % 20 == 19;
+#if BROSE9323_OLD_FRAMES
+		const unsigned long strobes = panelSim().strobes();
+		simShow(d, force);
+		TEST_ASSERT_EQUAL(force ? W * H : changed, panelSim().strobes() - strobes);
+#else
+		simShow(d, force);
+#endif
+		TEST_ASSERT_EQUAL(0, panelSim().mismatches(d));
+		memcpy(shown, ref.dots, sizeof(shown));
+	}
+}
+
+// A scroll by the height or more leaves the fill behind
+static void test_scroll_out(void) {
+	static Display d;
+	d.begin();
+	d.fillScreen(0);
+	d.fillRect(10, 2, 20, 8, 1);
+	d.scroll(0, 100);
+	for (uint8_t x = 0; x < W; x++) {
+		TEST_ASSERT_EQUAL_UINT8(0, d.getColumnByte(x, 0));
+		TEST_ASSERT_EQUAL_UINT8(0, d.getColumnByte(x, 1));
+	}
+	d.scroll(0, -100, 1);
+	for (uint8_t x = 0; x < W; x++) {
+		TEST_ASSERT_EQUAL_UINT8(0xFF, d.getColumnByte(x, 0));
+		TEST_ASSERT_EQUAL_UINT8(0xFF, d.getColumnByte(x, 1));
+	}
+	d.scrollRect(20, 4, 10, 6, 0, 40);
+	d.scrollRect(40, 4, 10, 6, 0, -16);
+	for (uint8_t y = 0; y < H; y++) {
+		for (uint8_t x = 0; x < W; x++) {
+			const bool cleared = y >= 4 && y < 10 && ((x >= 20 && x < 30) || (x >= 40 && x < 50));
+			TEST_ASSERT_EQUAL(!cleared, d.getBufferPixel(x, y));
+		}
+	}
+	simShow(d);
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(d));
+}
+#endif
+
+// planFlips() with few and many changed dots, and with every column marked
+// dirty so the dots have to be compared
+static void test_plan_benchmark(void) {
+	static const char* const names[] = {
+		"5 changed dots", "50 changed dots", "all dirty, 5 dots", "all dirty, 400 dots"
+	};
+	const uint16_t changes[] = { 5, 50, 5, 400 };
+	static Display d;
+	d.begin();
+	d.fillScreen(0);
+	simShow(d, true);
+	randomSeed(1);
+	for (uint8_t w = 0; w < 4; w++) {
+		const int reps = 500;
+		double total = 0;
+		for (int r = 0; r < reps; r++) {
+			for (uint16_t i = 0; i < changes[w]; i++) d.drawPixel(random(W), random(H), random(2));
+			if (w >= 2) d.markDirty(0, W);
+			const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+			volatile uint16_t strobes = d.planFlips().strobes;
+			(void)strobes;
+			total += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+			simShow(d);
+		}
+		char line[96];
+#ifdef BROSE9323_COLUMN_MAJOR
+		snprintf(line, sizeof(line), "%-20s column-major %7.0f ns", names[w], total / reps);
+#else
+		snprintf(line, sizeof(line), "%-20s row-major %7.0f ns", names[w], total / reps);
+#endif
+		TEST_MESSAGE(line);
+	}
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+#ifdef BROSE9323_COLUMN_MAJOR
+	RUN_TEST(test_same_frames);
+	RUN_TEST(test_scroll_out);
+#endif
+	RUN_TEST(test_plan_benchmark);
+	return UNITY_END();
+}
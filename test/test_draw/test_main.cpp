@@ -0,0 +1,191 @@
+// Lines, rectangles and bitmaps are drawn a byte at a time; they have to
+// leave the same frame as drawing them dot by dot, clipped at every edge,
+// and mark the columns they change so display() flips them. Also reports
+// the time per call against the dot by dot drawing:
+//
+//   pio test -e test -f test_draw -v
+
+#include <chrono>
+
+#include <unity.h>
+#include <PanelSim.h>
+
+#define W 84
+#define H 16
+
+void setUp(void) {
+	simReset();
+	panelSim().begin();
+}
+
+void tearDown(void) {
+}
+
+// The shapes dot by dot, as the Adafruit_GFX defaults draw them
+static void refFillRect(BROSE9323& d, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+	for (int16_t j = 0; j < h; j++) {
+		for (int16_t i = 0; i < w; i++) d.drawPixel(x + i, y + j, color);
+	}
+}
+
+static void refBitmap(BROSE9323& d, int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, int32_t bg) {
+	const int16_t byte_width = (w + 7) / 8;
+	for (int16_t j = 0; j < h; j++) {
+		for (int16_t i = 0; i < w; i++) {
+			if (bitmap[j * byte_width + i / 8] & (0x80 >> (i & 7))) {
+				d.drawPixel(x + i, y + j, color);
+			} else if (bg >= 0) {
+				d.drawPixel(x + i, y + j, bg);
+			}
+		}
+	}
+}
+
+static int differences(BROSE9323& a, BROSE9323& b) {
+	int n = 0;
+	for (int16_t y = 0; y < H; y++) {
+		for (int16_t x = 0; x < W; x++) n += a.getBufferPixel(x, y) != b.getBufferPixel(x, y);
+	}
+	return n;
+}
+
+// Random shapes reaching over every edge, the panels are checked after
+// every few calls
+static void test_same_as_dots(void) {
+	BROSE9323 d(W, H, 28);
+	BROSE9323 ref(W, H, 28);
+	d.begin();
+	d.fillScreen(0);
+	ref.fillScreen(0);
+	simShow(d, true);
+	uint8_t bitmap[5 * 12];
+	randomSeed(3);
+	for (uint16_t t = 0; t < 20000; t++) {
+		const int16_t x = random(-13, 97);
+		const int16_t y = random(-4, 20);
+		const int16_t w = random(1, 41);
+		int16_t h = random(1, 19);
+		const uint16_t color = random(2);
+		const uint16_t bg = random(2);
+		for (uint8_t i = 0; i < sizeof(bitmap); i++) bitmap[i] = random(256);
+		switch (random(6)) {
+			case 0:
+				d.drawFastHLine(x, y, w, color);
+				refFillRect(ref, x, y, w, 1, color);
+				break;
+			case 1:
+				d.drawFastVLine(x, y, h, color);
+				refFillRect(ref, x, y, 1, h, color);
+				break;
+			case 2:
+				d.fillRect(x, y, w, h, color);
+				refFillRect(ref, x, y, w, h, color);
+				break;
+			case 3:
+				if (h > 12) h = 12;
+				d.drawBitmap(x, y, (const uint8_t*)bitmap, w, h, color);
+				refBitmap(ref, x, y, bitmap, w, h, color, -1);
+				break;
+			case 4:
+				if (h > 12) h = 12;
+				d.drawBitmap(x, y, bitmap, w, h, color, bg);
+				refBitmap(ref, x, y, bitmap, w, h, color, bg);
+				break;
+			case 5:
+				d.fillScreen(color);
+				refFillRect(ref, 0, 0, W, H, color);
+				break;
+		}
+		char message[64];
+		snprintf(message, sizeof(message), "call %u", t);
+		TEST_ASSERT_EQUAL_MESSAGE(0, differences(d, ref), message);
+		if (t % 7 == 0) {
+			simShow(d);
+			TEST_ASSERT_EQUAL_MESSAGE(0, panelSim().mismatches(d), message);
+		}
+	}
+}
+
+// A shift in direct mode strobes the dots it changes, plus for a scroll
+// the ones it moved the old state of out of the rectangle
+static void shiftDirect(BROSE9323& d, int16_t dx, int16_t dy, bool roll,
+		int16_t x = 0, int16_t y = 0, int16_t w = W, int16_t h = H) {
+	bool before[H][W];
+	for (int16_t j = 0; j < H; j++) {
+		for (int16_t i = 0; i < W; i++) before[j][i] = d.getBufferPixel(i, j);
+	}
+	const unsigned long strobes = panelSim().strobes();
+	if (roll) {
+		d.rollRect(x, y, w, h, dx, dy);
+	} else {
+		d.scrollRect(x, y, w, h, dx, dy, 1);
+	}
+	unsigned long changed = 0;
+	for (int16_t j = 0; j < H; j++) {
+		for (int16_t i = 0; i < W; i++) changed += before[j][i] != d.getBufferPixel(i, j);
+	}
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(d));
+	if (roll) {
+		TEST_ASSERT_EQUAL(changed, panelSim().strobes() - strobes);
+	} else {
+		TEST_ASSERT_GREATER_OR_EQUAL(changed, panelSim().strobes() - strobes);
+		TEST_ASSERT_LESS_OR_EQUAL(changed + abs(dx) * h + abs(dy) * w, panelSim().strobes() - strobes);
+	}
+}
+
+// Direct mode flips the dots as they are drawn
+static void test_direct_mode(void) {
+	BROSE9323 d(W, H, 28);
+	d.begin();
+	d.fillScreen(0);
+	simShow(d, true);
+	d.setDirect(true);
+	d.fillRect(-3, 2, 30, 9, 1);
+	d.drawFastHLine(20, 15, 70, 1);
+	d.drawFastVLine(83, -2, 10, 1);
+	d.drawBitmap(40, 0, _hannio_splash, 72, 16, 1, 0);
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(d));
+
+	shiftDirect(d, 5, -2, false);
+	shiftDirect(d, -7, 3, true);
+	shiftDirect(d, 0, 1, false, 10, 2, 30, 10);
+	shiftDirect(d, 4, 4, true, -5, 6, 40, 20);
+	d.setDirect(false);
+}
+
+template<typename F> static double nsPerCall(F f) {
+	const int calls = 2000;
+	const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	for (int i = 0; i < calls; i++) f(i & 1);
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / calls;
+}
+
+static void report(const char* name, double bytes, double dots) {
+	char line[96];
+	snprintf(line, sizeof(line), "%-18s %8.0f ns, dot by dot %8.0f ns", name, bytes, dots);
+	TEST_MESSAGE(line);
+}
+
+static void test_benchmark(void) {
+	BROSE9323 d(W, H, 28);
+	report("fillRect 84x16",
+		nsPerCall([&](int c) { d.fillRect(0, 0, W, H, c); }),
+		nsPerCall([&](int c) { refFillRect(d, 0, 0, W, H, c); }));
+	report("drawFastHLine 84",
+		nsPerCall([&](int c) { d.drawFastHLine(0, 5, W, c); }),
+		nsPerCall([&](int c) { refFillRect(d, 0, 5, W, 1, c); }));
+	report("drawFastVLine 16",
+		nsPerCall([&](int c) { d.drawFastVLine(5, 0, H, c); }),
+		nsPerCall([&](int c) { refFillRect(d, 5, 0, 1, H, c); }));
+	report("drawBitmap 72x16",
+		nsPerCall([&](int c) { d.drawBitmap(c, 0, _hannio_splash, 72, 16, 1, 0); }),
+		nsPerCall([&](int c) { refBitmap(d, c, 0, _hannio_splash, 72, 16, 1, 0); }));
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_same_as_dots);
+	RUN_TEST(test_direct_mode);
+	RUN_TEST(test_benchmark);
+	return UNITY_END();
+}
@@ -0,0 +1,206 @@
+// The ESP8266 build sends the changed columns of each frame as one COLUMNS
+// message; the controller's FrameReceiver has to rebuild exactly the frame
+// the ESP8266 drew. Here it writes into a second display of the ESP8266
+// build, test_loopback has the controller's side with the panels. The
+// bytes on the wire are compared against the old text protocol, which sent
+// 7 bytes per drawPixel(), 3 per fillScreen() and 2 per display().
+//
+//   pio test -e test_esp8266
+
+#include <unity.h>
+#include <Arduino.h>
+#include <FrameReceiver.h>
+
+#include <string>
+
+#ifdef ESP8266
+
+// Both directions of the serial link between the ESP8266 and the controller
+struct Link : Stream {
+	std::string to_controller;
+	std::string to_esp;
+
+	size_t write(uint8_t c) {
+		to_controller += (char)c;
+		return 1;
+	}
+	using Print::write;
+	int available(void) { return to_esp.size(); }
+	int read(void) {
+		if (to_esp.empty()) return -1;
+		const uint8_t c = to_esp[0];
+		to_esp.erase(0, 1);
+		return c;
+	}
+	int peek(void) { return to_esp.empty() ? -1 : (uint8_t)to_esp[0]; }
+};
+
+static Link link;
+static BROSE9323* esp;
+static BROSE9323* controller;  // only its buffer, the controller's frame
+static FrameReceiver* receiver;
+static unsigned long wire_bytes;
+static unsigned long messages;
+static unsigned long old_bytes;
+static std::string held;  // ACKs held back
+
+void setUp(void) {
+	simReset();
+	link = Link();
+	esp = new BROSE9323(84, 16, 28);
+	controller = new BROSE9323(84, 16, 28);
+	receiver = new FrameReceiver(*controller);
+	wire_bytes = messages = old_bytes = 0;
+	held.clear();
+}
+
+void tearDown(void) {
+	delete receiver;
+	delete controller;
+	delete esp;
+}
+
+// The controller's loop in main.cpp: every message is decoded and then
+// acknowledged, unless the ACK is lost on the way back or held back
+static void pump(bool ack = true, bool hold = false) {
+	wire_bytes += link.to_controller.size();
+	for (size_t i = 0; i < link.to_controller.size(); i++) {
+		const FrameStatus status = receiver->feed(link.to_controller[i]);
+		if (status == FRAME_PENDING) continue;
+		TEST_ASSERT_EQUAL(FRAME_OK, status);
+		TEST_ASSERT_EQUAL(FRAME_COLUMNS, receiver->type());
+		messages++;
+		uint8_t out[FRAME_OVERHEAD + 2];
+		const uint16_t n = receiver->ack(status, out);
+		if (hold) held.append((const char*)out, n);
+		else if (ack) link.to_esp.append((const char*)out, n);
+	}
+	link.to_controller.clear();
+}
+
+static void pixel(int16_t x, int16_t y, uint16_t color) {
+	esp->drawPixel(x, y, color);
+	old_bytes += 7;
+}
+
+static void clear(void) {
+	esp->fillScreen(0);
+	old_bytes += 3;
+}
+
+static void show(bool ack = true) {
+	esp->display();
+	old_bytes += 2;
+	pump(ack);
+}
+
+static void assertSameFrame(void) {
+	for (int16_t y = 0; y < 16; y++) {
+		for (int16_t x = 0; x < 84; x++) {
+			TEST_ASSERT_EQUAL(esp->getBufferPixel(x, y), controller->getBufferPixel(x, y));
+		}
+	}
+}
+
+// Full random redraws, sparse updates and a bar moving across
+static void test_frames_arrive(void) {
+	esp->begin(&link);
+	pump();
+	assertSameFrame();
+	randomSeed(1);
+	for (uint8_t f = 0; f < 5; f++) {
+		for (int16_t y = 0; y < 16; y++) {
+			for (int16_t x = 0; x < 84; x++) pixel(x, y, random(2));
+		}
+		show();
+		assertSameFrame();
+	}
+	for (uint8_t f = 0; f < 50; f++) {
+		for (uint8_t i = 0; i < 5; i++) pixel(random(84), random(16), random(2));
+		show();
+		assertSameFrame();
+	}
+	for (int16_t f = 0; f < 84; f++) {
+		clear();
+		for (int16_t y = 0; y < 16; y++) pixel(f, y, 1);
+		show();
+		assertSameFrame();
+	}
+
+	char line[96];
+	snprintf(line, sizeof(line), "%lu bytes in %lu messages, the text protocol needs %lu bytes",
+		wire_bytes, messages, old_bytes);
+	TEST_MESSAGE(line);
+	TEST_ASSERT_LESS_THAN(old_bytes / 4, wire_bytes);
+}
+
+// A frame without changes is not sent
+static void test_unchanged_frame(void) {
+	esp->begin(&link);
+	pump();
+	esp->drawPixel(3, 3, 1);
+	show();
+	const unsigned long sent = messages;
+	esp->drawPixel(3, 3, 1);
+	show();
+	show();
+	TEST_ASSERT_EQUAL(sent, messages);
+	assertSameFrame();
+}
+
+// Without an ACK the ESP8266 no longer knows what the controller shows and
+// sends every column with its next frame
+static void test_lost_ack_resends_all(void) {
+	esp->begin(&link);
+	pump();
+	esp->drawPixel(10, 5, 1);
+	show(false);
+	esp->drawPixel(20, 5, 1);
+	const unsigned long start = millis();
+	const unsigned long sent = wire_bytes;
+	show();
+	TEST_ASSERT_GREATER_OR_EQUAL(BROSE9323_ACK_TIMEOUT, millis() - start);
+	TEST_ASSERT_EQUAL(FRAME_OVERHEAD + FRAME_COLUMNS_MAX(84, 16), wire_bytes - sent);
+	assertSameFrame();
+}
+
+// An ACK that comes in after the ESP8266 gave up waiting answers the
+// message that timed out. When the resend after it is lost, that ACK must
+// not be taken for the resend's: the next frame has to send all columns
+// again. The dots are drawn below the "ESP Connected" text.
+static void test_late_ack(void) {
+	esp->begin(&link);
+	pump();
+	esp->drawPixel(10, 14, 1);
+	esp->display();
+	pump(true, true);
+	esp->drawPixel(20, 14, 1);
+	esp->display();
+	// The resend is lost, the late ACK arrives
+	link.to_controller.clear();
+	link.to_esp += held;
+	esp->drawPixel(30, 14, 1);
+	const unsigned long sent = wire_bytes;
+	show();
+	TEST_ASSERT_EQUAL(FRAME_OVERHEAD + FRAME_COLUMNS_MAX(84, 16), wire_bytes - sent);
+	assertSameFrame();
+}
+
+#else
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+#endif
+
+int main(int, char**) {
+	UNITY_BEGIN();
+#ifdef ESP8266
+	RUN_TEST(test_frames_arrive);
+	RUN_TEST(test_unchanged_frame);
+	RUN_TEST(test_lost_ack_resends_all);
+	RUN_TEST(test_late_ack);
+#endif
+	return UNITY_END();
+}
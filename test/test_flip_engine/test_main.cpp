@@ -0,0 +1,129 @@
+// The flip engine's timer interrupt runs with interrupts off, so no tick
+// may look at more than BROSE9323_SCAN_STEPS columns and dots. A walk that
+// finds nothing to flip in that many pauses and goes on with the next
+// tick, and the frames still have to reach the panels whole. The counters
+// tell how much of a walk each tick looks at:
+//
+//   pio test -e test_async -f test_flip_engine
+
+#include <unity.h>
+#include <PanelSim.h>
+
+#if defined(BROSE9323_ASYNC) && defined(BROSE9323_COUNTERS)
+
+#ifdef BROSE9323_COLUMN_MAJOR
+// A column is compared in one step
+#define STEP_DOTS (BROSE9323_SCAN_STEPS * 16)
+#else
+#define STEP_DOTS BROSE9323_SCAN_STEPS
+#endif
+
+static BROSE9323* gfx;
+
+// One frame handed to the engine and ticked until it is done
+struct Run {
+	unsigned long pauses = 0;    // ticks that stopped a walk at the cap
+	uint32_t diffed = 0;         // dots compared in all
+	uint32_t most_diffed = 0;    // dots compared in one tick
+};
+
+static Run show(bool force = false) {
+	Run r;
+	gfx->display(force);
+	while (gfx->busy()) {
+		const uint32_t diffed = gfx->counters().dots_diffed;
+		const uint16_t us = gfx->tick();
+		const uint32_t n = gfx->counters().dots_diffed - diffed;
+		if (n > r.most_diffed) r.most_diffed = n;
+		if (us == BROSE9323_SCAN_PAUSE) r.pauses++;
+		r.diffed += n;
+		simAdvance(us);
+	}
+	return r;
+}
+
+static int mismatches(void) {
+	int bad = 0;
+	for (int16_t y = 0; y < 16; y++) {
+		for (int16_t x = 0; x < 84; x++) bad += panelSim().dot(x, y, 84, 16, 28) != gfx->getBufferPixel(x, y);
+	}
+	return bad;
+}
+
+void setUp(void) {
+	simReset();
+	panelSim().begin();
+	gfx = new BROSE9323(84, 16, 28);
+	gfx->begin();
+	gfx->fillScreen(0);
+	show(true);
+}
+
+void tearDown(void) {
+	delete gfx;
+}
+
+static void test_full_frame(void) {
+	randomSeed(2);
+	for (int16_t y = 0; y < 16; y++) {
+		for (int16_t x = 0; x < 84; x++) gfx->drawPixel(x, y, random(2));
+	}
+	const Run r = show();
+	TEST_ASSERT_LESS_OR_EQUAL(STEP_DOTS, r.most_diffed);
+	TEST_ASSERT_EQUAL(0, mismatches());
+}
+
+// Every column is dirty but only the last dot of the walk changed. The
+// walk gets there over many ticks instead of one long one.
+static void test_sparse_frame(void) {
+	gfx->fillScreen(1);
+	gfx->fillScreen(0);
+	gfx->drawPixel(83, 15, 1);
+	const Run r = show();
+	TEST_ASSERT_LESS_OR_EQUAL(STEP_DOTS, r.most_diffed);
+#if BROSE9323_OLD_FRAMES
+	TEST_ASSERT_GREATER_OR_EQUAL(r.diffed / STEP_DOTS, r.pauses);
+#endif
+	TEST_ASSERT_EQUAL(1, panelSim().dot(83, 15, 84, 16, 28));
+	TEST_ASSERT_EQUAL(0, mismatches());
+}
+
+// Single dots, on the ATmega168 from the change log
+static void test_single_dots(void) {
+	randomSeed(3);
+	for (uint8_t f = 0; f < 20; f++) {
+		for (uint8_t i = 0; i < 5; i++) gfx->drawPixel(random(84), random(16), random(2));
+		const Run r = show();
+		TEST_ASSERT_LESS_OR_EQUAL(STEP_DOTS, r.most_diffed);
+		TEST_ASSERT_EQUAL(0, mismatches());
+	}
+}
+
+// A forced refresh still flips every dot once
+static void test_forced(void) {
+	gfx->fillRect(10, 3, 40, 9, 1);
+	const unsigned long pulses = panelSim().low_pulses;
+	const Run r = show(true);
+	TEST_ASSERT_LESS_OR_EQUAL(STEP_DOTS, r.most_diffed);
+	TEST_ASSERT_EQUAL(2 * 84 * 16, panelSim().low_pulses - pulses);
+	TEST_ASSERT_EQUAL(0, mismatches());
+}
+
+#else
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+#endif
+
+int main(int, char**) {
+	UNITY_BEGIN();
+#if defined(BROSE9323_ASYNC) && defined(BROSE9323_COUNTERS)
+	RUN_TEST(test_full_frame);
+	RUN_TEST(test_sparse_frame);
+	RUN_TEST(test_single_dots);
+	RUN_TEST(test_forced);
+#endif
+	return UNITY_END();
+}
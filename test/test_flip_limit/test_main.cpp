@@ -0,0 +1,124 @@
+// With a flip limit no display() may strobe more dots than the cap, the
+// panels have to catch up once the frame settles, and a region that keeps
+// changing must not starve the others.
+
+#include <unity.h>
+#include <PanelSim.h>
+
+#define LIMIT 100
+
+typedef BROSE9323Fixed<84, 16, 28> Display;
+
+static Display* display;
+static unsigned long most_strobes;  // most strobes of one show()
+
+void setUp(void) {
+	simReset();
+	panelSim().begin();
+	display = new Display;
+	display->begin();
+	display->fillScreen(0);
+	simShow(*display, true);
+	display->setFlipLimit(LIMIT);
+	most_strobes = 0;
+}
+
+void tearDown(void) {
+	delete display;
+}
+
+static void show(void) {
+	const unsigned long strobes = panelSim().strobes();
+	simShow(*display);
+	if (panelSim().strobes() - strobes > most_strobes) most_strobes = panelSim().strobes() - strobes;
+}
+
+// Calls display() until nothing is pending, returns how often
+static int converge(void) {
+	int calls = 0;
+	while (display->pending()) {
+		show();
+		TEST_ASSERT_LESS_THAN(1000, ++calls);
+	}
+	return calls;
+}
+
+static int regionMismatches(int x0, int x1) {
+	int bad = 0;
+	for (int y = 0; y < 16; y++) {
+		for (int x = x0; x < x1; x++) bad += panelSim().dot(x, y, 84, 16, 28) != display->getBufferPixel(x, y);
+	}
+	return bad;
+}
+
+// The whole screen toggles every frame
+static void test_flicker(void) {
+	for (uint8_t f = 0; f < 20; f++) {
+		display->fillScreen(f & 1);
+		show();
+	}
+	const int calls = converge();
+	TEST_ASSERT_EQUAL(LIMIT, most_strobes);
+#if BROSE9323_OLD_FRAMES
+	TEST_ASSERT_LESS_OR_EQUAL(84 * 16 / LIMIT + 1, calls);
+#else
+	// Without an old buffer the columns the flicker left dirty are walked
+	// whole, changed or not
+	TEST_ASSERT_LESS_OR_EQUAL(2 * (84 * 16 / LIMIT + 1), calls);
+#endif
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(*display));
+	TEST_ASSERT_GREATER_THAN(0, display->convergenceMicros());
+}
+
+// The left panel keeps changing, the other two still catch up
+static void test_fairness(void) {
+	display->fillRect(28, 0, 56, 16, 1);
+	randomSeed(1);
+	int frames = 0;
+	for (uint8_t f = 0; f < 200 && !frames; f++) {
+		for (uint8_t i = 0; i < 40; i++) display->drawPixel(random(28), random(16), random(2));
+		show();
+		if (regionMismatches(28, 84) == 0) frames = f + 1;
+	}
+	char line[64];
+	snprintf(line, sizeof(line), "right panels caught up after %d frames", frames);
+	TEST_MESSAGE(line);
+	TEST_ASSERT_GREATER_THAN(0, frames);
+	TEST_ASSERT_LESS_OR_EQUAL(2 * (56 * 16 / LIMIT + 1), frames);
+	TEST_ASSERT_EQUAL(LIMIT, most_strobes);
+	converge();
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(*display));
+}
+
+// A direct fillScreen() keeps to the cap as well and finishes later
+static void test_direct(void) {
+	display->setDirect(true);
+	const unsigned long strobes = panelSim().strobes();
+	display->fillScreen(1);
+#ifdef BROSE9323_ASYNC
+	while (display->busy()) simAdvance(display->tick());
+#endif
+	TEST_ASSERT_EQUAL(LIMIT, panelSim().strobes() - strobes);
+	converge();
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(*display));
+	display->setDirect(false);
+}
+
+// Without a cap a frame is flipped in one go
+static void test_unlimited(void) {
+	display->setFlipLimit(0);
+	display->fillScreen(1);
+	show();
+	TEST_ASSERT_EQUAL(84 * 16, most_strobes);
+	TEST_ASSERT_EQUAL(0, display->pending());
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(*display));
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_flicker);
+	RUN_TEST(test_fairness);
+	RUN_TEST(test_direct);
+	RUN_TEST(test_unlimited);
+	return UNITY_END();
+}
@@ -0,0 +1,78 @@
+// planFlips() has to predict the strobes and line changes display() makes,
+// and the grouped scan order has to need fewer line changes than going
+// column by column.
+
+#include <unity.h>
+#include <PanelSim.h>
+
+#define FRAMES 50
+
+void setUp(void) {
+	simReset();
+	panelSim().begin();
+}
+
+void tearDown(void) {
+}
+
+// Random frames of up to 300 dots drawn, as captured from randomFlip and
+// matrix they are scattered over all panels
+static void drawFrame(BROSE9323& d) {
+	const uint16_t n = random(300);
+	for (uint16_t i = 0; i < n; i++) d.drawPixel(random(84), random(16), random(2));
+}
+
+static void test_plan_matches_panel(void) {
+	for (uint8_t order = 0; order < 2; order++) {
+		BROSE9323 d(84, 16, 28);
+		d.begin();
+		d.setScanOrder(order ? BROSE9323::SCAN_GROUPED : BROSE9323::SCAN_COLUMNS);
+		d.fillScreen(0);
+		simShow(d, true);
+		randomSeed(1);
+		for (uint8_t f = 0; f < FRAMES; f++) {
+			drawFrame(d);
+			const BROSE9323::FlipPlanStats plan = d.planFlips();
+			const unsigned long strobes = panelSim().strobes();
+			const unsigned long lines = panelSim().line_changes;
+			simShow(d);
+			TEST_ASSERT_EQUAL(plan.strobes, panelSim().strobes() - strobes);
+			TEST_ASSERT_EQUAL(plan.transitions, panelSim().line_changes - lines);
+			TEST_ASSERT_EQUAL(0, panelSim().mismatches(d));
+		}
+	}
+}
+
+static void test_grouped_needs_fewer_transitions(void) {
+	unsigned long strobes[2] = {0, 0};
+	unsigned long transitions[2] = {0, 0};
+	for (uint8_t order = 0; order < 2; order++) {
+		BROSE9323 d(84, 16, 28);
+		d.begin();
+		d.setScanOrder(order ? BROSE9323::SCAN_GROUPED : BROSE9323::SCAN_COLUMNS);
+		d.fillScreen(0);
+		simShow(d, true);
+		randomSeed(2);
+		for (uint8_t f = 0; f < FRAMES; f++) {
+			drawFrame(d);
+			const BROSE9323::FlipPlanStats plan = d.planFlips();
+			strobes[order] += plan.strobes;
+			transitions[order] += plan.transitions;
+			simShow(d);
+		}
+	}
+
+	char line[96];
+	snprintf(line, sizeof(line), "columns: %lu strobes %lu transitions, grouped: %lu strobes %lu transitions",
+		strobes[0], transitions[0], strobes[1], transitions[1]);
+	TEST_MESSAGE(line);
+	TEST_ASSERT_EQUAL(strobes[0], strobes[1]);
+	TEST_ASSERT_LESS_THAN(transitions[0], transitions[1]);
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_plan_matches_panel);
+	RUN_TEST(test_grouped_needs_fewer_transitions);
+	return UNITY_END();
+}
@@ -0,0 +1,281 @@
+// The host senders against the controller's FrameReceiver over a pty:
+// fliprender (src/host/fliprender.cpp) and serial-simple.py --stream have
+// to get every frame across, resend all of it after a bad ACK, and must
+// not take a late ACK for the message after a lost one. A message that
+// fails its CRC has already been written to the buffer, the panels must
+// still end up showing what the buffer holds.
+//
+// fliprender is run from .pio/build/native/program (pio run -e native) or
+// from $FLIPRENDER, serial-simple.py needs python3 with pyserial. A test
+// whose sender is missing is ignored.
+
+#include <unity.h>
+#include <PanelSim.h>
+#include <FrameReceiver.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
+
+// What the controller does with a message
+enum Answer {
+	ACK,          // shows it and acknowledges it
+	NAK,          // shows it and answers FRAME_BAD_CRC
+	CORRUPT_ACK,  // shows it, its ACK arrives with a bad CRC
+	LOST          // never receives it, the ACK of the message before comes in late
+};
+
+static BROSE9323* controller;
+static FrameReceiver* receiver;
+static int master = -1;
+static int slave = -1;
+static std::string slave_path;
+static std::vector<std::string> messages;  // every message received, lost ones too
+static std::string output;                 // what the sender printed
+
+void setUp(void) {
+	simReset();
+	panelSim().begin();
+	controller = new BROSE9323(84, 16, 28);
+	controller->begin();
+	receiver = new FrameReceiver(*controller);
+	messages.clear();
+	output.clear();
+
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	TEST_ASSERT_TRUE(master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0);
+	slave_path = ptsname(master);
+	// Held open so the pty stays up between the sender's open() calls
+	slave = open(slave_path.c_str(), O_RDWR | O_NOCTTY);
+	struct termios tio;
+	tcgetattr(slave, &tio);
+	cfmakeraw(&tio);
+	tcsetattr(slave, TCSANOW, &tio);
+}
+
+void tearDown(void) {
+	close(slave);
+	close(master);
+	delete receiver;
+	delete controller;
+}
+
+// Wall clock, millis() is the simulation's
+static unsigned long wallMs(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000UL + ts.tv_nsec / 1000000UL;
+}
+
+// Starts a sender, its stdout and stderr go to *out
+static pid_t spawn(const char* const argv[], int* out) {
+	int fds[2];
+	TEST_ASSERT_EQUAL(0, pipe(fds));
+	const pid_t pid = fork();
+	if (pid == 0) {
+		dup2(fds[1], 1);
+		dup2(fds[1], 2);
+		close(fds[0]);
+		close(fds[1]);
+		execvp(argv[0], (char* const*)argv);
+		_exit(127);
+	}
+	close(fds[1]);
+	fcntl(fds[0], F_SETFL, O_NONBLOCK);
+	*out = fds[0];
+	return pid;
+}
+
+static void drain(int out) {
+	char buf[256];
+	ssize_t n;
+	while ((n = read(out, buf, sizeof(buf))) > 0) output.append(buf, n);
+}
+
+// Plays the controller until the sender exits, count messages came in or
+// the time is up. answer(n) says what to do with message n (from 0).
+template <typename F> static int serve(pid_t pid, int out, size_t count, unsigned long timeout_ms, F answer) {
+	const unsigned long start = wallMs();
+	std::string message;
+	std::string last_ack;
+	int status = -1;
+	while (messages.size() < count && wallMs() - start < timeout_ms) {
+		if (waitpid(pid, &status, WNOHANG) == pid) break;
+		drain(out);
+		struct pollfd pfd = { master, POLLIN, 0 };
+		if (poll(&pfd, 1, 50) <= 0) continue;
+		uint8_t rx[256];
+		const ssize_t n = read(master, rx, sizeof(rx));
+		for (ssize_t i = 0; i < n; i++) {
+			// Split the stream into messages first, so a lost one is never fed
+			if (message.empty() && rx[i] != FRAME_SYNC) continue;
+			message += (char)rx[i];
+			if (message.size() < FRAME_HEADER_SIZE) continue;
+			const uint16_t len = (uint8_t)message[3] | (uint8_t)message[4] << 8;
+			if (message.size() < (size_t)(FRAME_OVERHEAD + len)) continue;
+
+			const Answer a = answer(messages.size());
+			messages.push_back(message);
+			if (a == LOST) {
+				if (write(master, last_ack.data(), last_ack.size()) < 0) TEST_FAIL_MESSAGE("write");
+			} else {
+				FrameStatus s = FRAME_PENDING;
+				for (size_t j = 0; j < message.size(); j++) s = receiver->feed(message[j]);
+				TEST_ASSERT_EQUAL(FRAME_OK, s);
+				if (receiver->type() != FRAME_HELLO) simShow(*controller);
+				uint8_t ack[FRAME_OVERHEAD + 2];
+				last_ack.assign((const char*)ack, receiver->ack(a == NAK ? FRAME_BAD_CRC : s, ack));
+				std::string sent = last_ack;
+				if (a == CORRUPT_ACK) sent[sent.size() - 1] ^= 0xFF;
+				if (write(master, sent.data(), sent.size()) < 0) TEST_FAIL_MESSAGE("write");
+			}
+			message.clear();
+		}
+	}
+	if (status == -1) {
+		kill(pid, SIGTERM);
+		waitpid(pid, &status, 0);
+	}
+	drain(out);
+	close(out);
+	return status;
+}
+
+static uint8_t type(size_t n) {
+	return messages[n][1];
+}
+
+static uint16_t length(size_t n) {
+	return (uint8_t)messages[n][3] | (uint8_t)messages[n][4] << 8;
+}
+
+// Feeds a message to the controller, with one payload byte flipped on the
+// way if corrupt, and shows it the way main.cpp does: only when it is OK
+static FrameStatus deliver(uint8_t type, const uint8_t* payload, uint16_t len, bool corrupt = false) {
+	std::vector<uint8_t> message(len + FRAME_OVERHEAD);
+	frameBuild(type, 1, payload, len, message.data());
+	if (corrupt) message[FRAME_HEADER_SIZE] ^= 0x10;
+	FrameStatus s = FRAME_PENDING;
+	for (size_t i = 0; i < message.size(); i++) s = receiver->feed(message[i]);
+	if (s == FRAME_OK) simShow(*controller);
+	return s;
+}
+
+static void test_bad_crc(void) {
+	const uint16_t size = 11 * 16;
+	std::vector<uint8_t> a(size), b(size), payload(FRAME_COLUMNS_MAX(84, 16));
+	randomSeed(4);
+	for (uint16_t i = 0; i < size; i++) a[i] = random(256);
+	for (uint16_t i = 0; i < size; i++) b[i] = random(256);
+	TEST_ASSERT_EQUAL(FRAME_OK, deliver(FRAME_FULL, a.data(), size));
+
+	// The resent frame only differs from the broken one in the flipped byte
+	TEST_ASSERT_EQUAL(FRAME_BAD_CRC, deliver(FRAME_FULL, b.data(), size, true));
+	TEST_ASSERT_EQUAL(FRAME_OK, deliver(FRAME_FULL, b.data(), size));
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(*controller));
+
+	// Column 3 is broken, the next message only carries column 40
+	a = b;
+	for (uint8_t y = 0; y < 16; y++) b[y * 11] ^= 1 << 3;
+	uint16_t len = frameEncodeColumns(a.data(), b.data(), 84, 16, payload.data());
+	TEST_ASSERT_EQUAL(FRAME_BAD_CRC, deliver(FRAME_COLUMNS, payload.data(), len, true));
+	a = b;
+	for (uint8_t y = 0; y < 16; y++) b[y * 11 + 5] ^= 1;
+	len = frameEncodeColumns(a.data(), b.data(), 84, 16, payload.data());
+	TEST_ASSERT_EQUAL(FRAME_OK, deliver(FRAME_COLUMNS, payload.data(), len));
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(*controller));
+
+	// A broken key frame has cleared the buffer, an empty delta shows it
+	len = frameEncodeRLE(NULL, b.data(), size, payload.data(), payload.size());
+	TEST_ASSERT_EQUAL(FRAME_BAD_CRC, deliver(FRAME_KEY_RLE, payload.data(), len, true));
+	TEST_ASSERT_EQUAL(FRAME_OK, deliver(FRAME_DELTA, NULL, 0));
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(*controller));
+}
+
+static void test_fliprender(void) {
+	const char* path = getenv("FLIPRENDER");
+	if (!path) path = ".pio/build/native/program";
+	if (access(path, X_OK) != 0) TEST_IGNORE_MESSAGE("fliprender not built, run pio run -e native");
+
+	// Message 5's ACK is corrupt, message 10 is lost and 9's ACK comes late
+	const char* const argv[] = { path, "-e", "randomFlip", slave_path.c_str(), NULL };
+	int out;
+	const pid_t pid = spawn(argv, &out);
+	serve(pid, out, 16, 20000, [](size_t n) {
+		return n == 5 ? CORRUPT_ACK : n == 10 ? LOST : ACK;
+	});
+	TEST_MESSAGE(output.c_str());
+	TEST_ASSERT_EQUAL(16, messages.size());
+
+	// The first message and the ones after each failure carry all columns
+	for (size_t n = 0; n < messages.size(); n++) {
+		if (type(n) != FRAME_COLUMNS) continue;
+		char line[32];
+		snprintf(line, sizeof(line), "message %u", (unsigned)n);
+		if (n == 0 || n == 6 || n == 11) {
+			TEST_ASSERT_EQUAL_MESSAGE(FRAME_COLUMNS_MAX(84, 16), length(n), line);
+		} else {
+			TEST_ASSERT_LESS_THAN_MESSAGE(FRAME_COLUMNS_MAX(84, 16), length(n), line);
+		}
+	}
+	TEST_ASSERT_NOT_NULL(strstr(output.c_str(), "resyncs=2"));
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(*controller));
+}
+
+static void test_serial_simple(void) {
+	if (system("python3 -c 'import serial' 2>/dev/null") != 0) {
+		TEST_IGNORE_MESSAGE("python3 with pyserial not found");
+	}
+
+	// A sprite moving over a static pattern
+	char frames_path[] = "/tmp/loopback-XXXXXX";
+	const int fd = mkstemp(frames_path);
+	TEST_ASSERT_TRUE(fd >= 0);
+	const uint8_t frame_count = 20;
+	std::vector<uint8_t> frame(11 * 16);
+	for (uint8_t f = 0; f < frame_count; f++) {
+		for (uint16_t i = 0; i < frame.size(); i++) frame[i] = i * 37;
+		for (uint8_t y = 4; y < 12; y++) frame[y * 11 + f / 2] = 0xFF;
+		if (write(fd, frame.data(), frame.size()) < 0) TEST_FAIL_MESSAGE("write");
+	}
+	close(fd);
+
+	// Message 0 is the HELLO. Frame 2 is refused, frame 5 is lost and the
+	// ACK of frame 4 comes late.
+	const char* const argv[] = { "python3", "serial-simple.py", "--stream", frames_path, "--port", slave_path.c_str(), NULL };
+	int out;
+	const pid_t pid = spawn(argv, &out);
+	const int status = serve(pid, out, 100, 30000, [](size_t n) {
+		return n == 3 ? NAK : n == 7 ? LOST : ACK;
+	});
+	unlink(frames_path);
+	TEST_MESSAGE(output.c_str());
+	TEST_ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+	TEST_ASSERT_NOT_NULL(strstr(output.c_str(), "Sent 20 frames"));
+
+	// Both failures are resent as key frames
+	TEST_ASSERT_EQUAL(FRAME_HELLO, type(0));
+	TEST_ASSERT_EQUAL(frame_count + 3, messages.size());
+	TEST_ASSERT_NOT_EQUAL(FRAME_DELTA, type(4));
+	TEST_ASSERT_NOT_EQUAL(FRAME_DELTA, type(8));
+	for (uint8_t y = 0; y < 16; y++) {
+		for (uint8_t x = 0; x < 84; x++) {
+			TEST_ASSERT_EQUAL((bool)(frame[y * 11 + x / 8] & (1 << (x & 7))), controller->getBufferPixel(x, y));
+		}
+	}
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(*controller));
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_bad_crc);
+	RUN_TEST(test_fliprender);
+	RUN_TEST(test_serial_simple);
+	return UNITY_END();
+}
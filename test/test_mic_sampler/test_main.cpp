@@ -0,0 +1,145 @@
+// MicSampler has to turn the microphone's pulse trains into a level and
+// report an onset once per beat: not on silence, not on a steady noise,
+// not faster than its holdoff, and without blocking when pulses come in
+// faster than update() reads them.
+
+#include <unity.h>
+#include <MicSampler.h>
+
+// Feeds a pulse train to a sampler and calls update() every 10 ms, as the
+// sound effect does
+struct Feed {
+	MicSampler mic;
+	uint32_t t = 1000000;
+	uint32_t next_update = 1000000;
+	int onsets = 0;
+	uint16_t max_level = 0;
+
+	// pulse(t, width, gap) gives the next high pulse, width 0 for none
+	template <typename F> void run(uint32_t duration, F pulse) {
+		const uint32_t end = t + duration;
+		while (t < end) {
+			uint32_t width = 0, gap = 0;
+			pulse(t, width, gap);
+			if (width) {
+				mic.edge(true, t);
+				t += width;
+				mic.edge(false, t);
+			}
+			t += gap;
+			while ((int32_t)(t - next_update) >= 0) {
+				mic.update(next_update);
+				if (mic.onset()) onsets++;
+				if (mic.level() > max_level) max_level = mic.level();
+				next_update += 10000;
+			}
+		}
+	}
+};
+
+void setUp(void) {
+	simReset();
+}
+
+void tearDown(void) {
+}
+
+static void test_silence(void) {
+	Feed f;
+	f.run(3000000, [](uint32_t, uint32_t& w, uint32_t& g) { w = 0; g = 1000; });
+	TEST_ASSERT_EQUAL(0, f.onsets);
+	TEST_ASSERT_EQUAL(0, f.mic.level());
+}
+
+// A noise that starts and stays counts once
+static void test_steady_noise(void) {
+	Feed f;
+	f.run(3000000, [](uint32_t, uint32_t& w, uint32_t& g) { w = 400; g = 600; });
+	TEST_ASSERT_EQUAL(1, f.onsets);
+	TEST_ASSERT_EQUAL(400, f.mic.level());
+	TEST_ASSERT_EQUAL(0, f.mic.dropped());
+}
+
+// Ten beats over a low background noise
+static void test_beats(void) {
+	Feed f;
+	const uint32_t start = f.t;
+	f.run(5000000, [start](uint32_t t, uint32_t& w, uint32_t& g) {
+		if ((t - start) % 500000 < 30000) {
+			w = 3000;
+			g = 2000;
+		} else {
+			w = 150;
+			g = 4850;
+		}
+	});
+	TEST_ASSERT_EQUAL(10, f.onsets);
+	TEST_ASSERT_EQUAL(3000, f.max_level);
+}
+
+// Bursts at 25 Hz come faster than the holdoff of 100 ms
+static void test_holdoff(void) {
+	Feed f;
+	const uint32_t start = f.t;
+	f.run(2000000, [start](uint32_t t, uint32_t& w, uint32_t& g) {
+		w = (t - start) % 40000 < 5000 ? 3000 : 0;
+		g = w ? 2000 : 1000;
+	});
+	TEST_ASSERT_GREATER_THAN(0, f.onsets);
+	TEST_ASSERT_LESS_OR_EQUAL(20, f.onsets);
+}
+
+// Clicks below the threshold are no onsets
+static void test_quiet_clicks(void) {
+	Feed f;
+	f.run(1000000, [](uint32_t, uint32_t& w, uint32_t& g) { w = 60; g = 5000; });
+	TEST_ASSERT_EQUAL(0, f.onsets);
+}
+
+// At 20 kHz the ring overflows, the oldest widths are dropped
+static void test_fast_pulses(void) {
+	Feed f;
+	f.run(1000000, [](uint32_t, uint32_t& w, uint32_t& g) { w = 20; g = 30; });
+	TEST_ASSERT_GREATER_THAN(0, f.mic.dropped());
+	TEST_ASSERT_EQUAL(20, f.mic.level());
+	TEST_ASSERT_EQUAL(0, f.onsets);
+}
+
+// A pulse that is still high counts with its width so far
+static void test_stuck_high(void) {
+	Feed f;
+	f.mic.edge(true, f.t);
+	f.mic.update(f.t + 200000);
+	TEST_ASSERT_EQUAL(0xFFFF, f.mic.level());
+	TEST_ASSERT_TRUE(f.mic.onset());
+	TEST_ASSERT_FALSE(f.mic.onset());
+}
+
+// Through the pin's interrupt, as on the board
+static void test_interrupt(void) {
+	MicSampler mic;
+	mic.begin(2);
+	simAdvance(1000000);
+	for (uint8_t i = 0; i < 5; i++) {
+		simSetPin(2, HIGH);
+		simAdvance(2000);
+		simSetPin(2, LOW);
+		simAdvance(1000);
+	}
+	mic.update(micros());
+	TEST_ASSERT_EQUAL(2000, mic.level());
+	TEST_ASSERT_TRUE(mic.onset());
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_silence);
+	RUN_TEST(test_steady_noise);
+	RUN_TEST(test_beats);
+	RUN_TEST(test_holdoff);
+	RUN_TEST(test_quiet_clicks);
+	RUN_TEST(test_fast_pulses);
+	RUN_TEST(test_stuck_high);
+	RUN_TEST(test_interrupt);
+	return UNITY_END();
+}
@@ -0,0 +1,115 @@
+// The port register backend (BROSE9323_io.h) writes the ADDR, COL, ROW and
+// data lines a port at a time. The panels have to see the same coils
+// selected as with digitalWrite(), the lines must hold while ENABLE is low
+// and the other pins of the ports must keep their levels, for either
+// wiring:
+//
+//   pio test -e test_port_io -e test_168 -e test_plcc -f test_pin_backends
+
+#include <unity.h>
+#include <PanelSim.h>
+
+#ifdef BROSE9323_PORT_IO
+
+static uint32_t display_pins;    // simPinLevels() bits of the display's pins
+static uint32_t others;          // levels of the other pins
+static uint32_t low_levels;      // the lines at the last falling edge
+static unsigned long moved;      // low pulses during which a line changed
+static unsigned long clobbered;  // ENABLE edges with another pin changed
+
+static uint32_t pinBit(uint8_t pin) {
+	return 1UL << pin;
+}
+
+static void onEnable(uint8_t level) {
+	const uint32_t levels = simPinLevels() & ~pinBit(panelSim().wiring.enable);
+	if (!level) {
+		low_levels = levels;
+	} else if (levels != low_levels) {
+		moved++;
+	}
+	if ((levels & ~display_pins) != others) clobbered++;
+}
+
+void setUp(void) {
+	simReset();
+	panelSim().begin();
+	const PanelSim::Wiring& w = panelSim().wiring;
+	display_pins = pinBit(w.enable) | pinBit(w.col_data) | pinBit(w.row_reset) | pinBit(w.row_set);
+	for (uint8_t i = 0; i < 5; i++) display_pins |= pinBit(w.col[i]) | pinBit(w.row[i]) | (i < 3 ? pinBit(w.addr[i]) : 0);
+	moved = clobbered = 0;
+}
+
+void tearDown(void) {
+	panelSim().on_enable = NULL;
+}
+
+static void show(BROSE9323& d, bool force = false) {
+	simShow(d, force);
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(d));
+}
+
+// Sets the pins the display does not use to alternating levels
+static void setOthers(void) {
+	others = 0;
+	for (uint8_t pin = 0; pin < 20; pin++) {
+		if (display_pins & pinBit(pin)) continue;
+		digitalWrite(pin, pin & 1);
+		if (pin & 1) others |= pinBit(pin);
+	}
+	TEST_ASSERT_EQUAL_UINT32(others, simPinLevels() & ~display_pins);
+}
+
+// Single dots, shapes, text, a scroll, a forced refresh and direct mode
+static void test_lines(void) {
+	BROSE9323 d(84, 16, 28);
+	d.begin();
+	setOthers();
+	panelSim().on_enable = onEnable;
+	d.fillScreen(0);
+	show(d, true);
+	randomSeed(7);
+	for (uint8_t f = 0; f < 20; f++) {
+		for (uint8_t i = 0; i < 30; i++) d.drawPixel(random(84), random(16), random(2));
+		show(d);
+	}
+	d.fillRect(10, 2, 30, 9, 1);
+	d.drawFastHLine(0, 15, 84, 1);
+	show(d);
+	d.setTextColor(1, 0);
+	d.setCursor(2, 4);
+	d.print("9323");
+	show(d);
+	d.scroll(3, -1);
+	show(d);
+	show(d, true);
+	d.setDirect(true);
+	d.fillRect(40, 0, 8, 16, 0);
+	d.drawPixel(83, 15, 1);
+	d.setDirect(false);
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(d));
+
+	// 30 dots a frame and more
+	TEST_ASSERT_GREATER_THAN(500, panelSim().strobes());
+	TEST_ASSERT_EQUAL(0, panelSim().bad_data);
+	TEST_ASSERT_EQUAL(0, moved);
+	TEST_ASSERT_EQUAL(0, clobbered);
+	// Every pulse is as long as the flip time, as with digitalWrite()
+	TEST_ASSERT_EQUAL(280, panelSim().min_low_us);
+	TEST_ASSERT_EQUAL(280, panelSim().max_low_us);
+}
+#else
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+#endif
+
+int main(int, char**) {
+	UNITY_BEGIN();
+#ifdef BROSE9323_PORT_IO
+	RUN_TEST(test_lines);
+#endif
+	return UNITY_END();
+}
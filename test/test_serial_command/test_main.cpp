@@ -0,0 +1,79 @@
+// SerialCommand splits the serial input into commands. A line too long for
+// its buffer must not be run cut short, it is reported whole and the next
+// line is read as usual.
+
+#include <unity.h>
+#include <Arduino.h>
+#include <SerialCommand.h>
+
+#include <string>
+
+// Serial input that is all there at once
+struct Input : Stream {
+	std::string rx;
+
+	size_t write(uint8_t) { return 1; }
+	using Print::write;
+	int available(void) { return rx.size(); }
+	int read(void) {
+		if (rx.empty()) return -1;
+		const uint8_t c = rx[0];
+		rx.erase(0, 1);
+		return c;
+	}
+	int peek(void) { return rx.empty() ? -1 : (uint8_t)rx[0]; }
+};
+
+static Input input;
+
+void setUp(void) {
+	input = Input();
+}
+
+void tearDown(void) {
+}
+
+static void test_commands(void) {
+	SerialCommand command(input);
+	input.rx = "  !fx 3\r\nhello world \n\n!bogus\n";
+	TEST_ASSERT_TRUE(command.poll());
+	TEST_ASSERT_EQUAL(CMD_EFFECT, command.type());
+	TEST_ASSERT_EQUAL_STRING("3", command.argument());
+	command.clear();
+	TEST_ASSERT_TRUE(command.poll());
+	TEST_ASSERT_EQUAL(CMD_TEXT, command.type());
+	TEST_ASSERT_EQUAL_STRING("hello world", command.argument());
+	command.clear();
+	TEST_ASSERT_TRUE(command.poll());
+	TEST_ASSERT_EQUAL(CMD_UNKNOWN, command.type());
+	command.clear();
+	TEST_ASSERT_FALSE(command.poll());
+}
+
+// The first SERIAL_COMMAND_SIZE bytes of the long line are a command of
+// their own, which must not run
+static void test_too_long(void) {
+	SerialCommand command(input);
+	input.rx = "!timing 20";
+	input.rx.append(SERIAL_COMMAND_SIZE, '0');
+	input.rx += "\n!stats\n";
+	TEST_ASSERT_TRUE(command.poll());
+	TEST_ASSERT_EQUAL(CMD_TOO_LONG, command.type());
+	command.clear();
+	TEST_ASSERT_TRUE(command.poll());
+	TEST_ASSERT_EQUAL(CMD_STATS, command.type());
+	command.clear();
+
+	// A line that just fits is still run
+	input.rx = std::string(SERIAL_COMMAND_SIZE, 'x') + "\n";
+	TEST_ASSERT_TRUE(command.poll());
+	TEST_ASSERT_EQUAL(CMD_TEXT, command.type());
+	TEST_ASSERT_EQUAL(SERIAL_COMMAND_SIZE, strlen(command.argument()));
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_commands);
+	RUN_TEST(test_too_long);
+	return UNITY_END();
+}
@@ -0,0 +1,160 @@
+// BROSE9323Tiled has to put every dot of a Layout on its own coil of the
+// right panel, mounted as the layout says, after display() and in direct
+// mode. The coils are checked against an address model written out here.
+
+#include <unity.h>
+#include <PanelSim.h>
+
+#include <set>
+
+typedef BROSE9323 B;
+
+// Three panels of different widths in a row, reordered and mounted each
+// way
+constexpr B::Layout row = { 3, 1, { 28, 14, 20 }, { 16 }, {
+	B::panel(2), B::panel(0, B::MIRROR_X), B::panel(1, B::ROTATE_180)
+} };
+
+// Three equal panels as wired, as BROSE9323Fixed<84, 16, 28> drives them
+constexpr B::Layout three = { 3, 1, { 28, 28, 28 }, { 16 }, { B::panel(0), B::panel(1), B::panel(2) } };
+
+// Taller layouts, BROSE9323_COLUMN_MAJOR keeps a column in 16 bits
+#ifndef BROSE9323_COLUMN_MAJOR
+// Two rows of four, the bottom row upside down and addressed right to left
+constexpr B::Layout wall = { 4, 2, { 28, 28, 28, 28 }, { 16, 16 }, {
+	B::panel(0), B::panel(1), B::panel(2), B::panel(3),
+	B::panel(7, B::ROTATE_180), B::panel(6, B::ROTATE_180), B::panel(5, B::ROTATE_180), B::panel(4, B::ROTATE_180)
+} };
+
+// Three high, of mixed heights
+constexpr B::Layout stack = { 1, 3, { 28 }, { 16, 8, 16 }, {
+	B::panel(2), B::panel(0, B::MIRROR_Y), B::panel(1, B::MIRROR_X)
+} };
+
+// Mixed widths and heights
+constexpr B::Layout mixed = { 3, 2, { 28, 14, 20 }, { 16, 12 }, {
+	B::panel(0), B::panel(1), B::panel(2),
+	B::panel(3, B::MIRROR_X), B::panel(4), B::panel(5, B::ROTATE_180)
+} };
+#endif
+
+void setUp(void) {
+	simReset();
+	panelSim().begin();
+}
+
+void tearDown(void) {
+}
+
+// Panel, column and row lines of dot (x, y)
+static void model(const B::Layout& l, int x, int y, int& panel, int& col, int& row) {
+	int tc = 0, x0 = 0;
+	while (tc < l.columns - 1 && x >= x0 + l.widths[tc]) x0 += l.widths[tc++];
+	int tr = 0, y0 = 0;
+	while (tr < l.rows - 1 && y >= y0 + l.heights[tr]) y0 += l.heights[tr++];
+	const int cell = l.panels[tr * l.columns + tc];
+	const int flags = cell >> 3;
+	panel = cell & 7;
+	int n = flags & B::MIRROR_X ? x - x0 : l.widths[tc] - 1 - (x - x0);
+	col = (n + 1 + n / 7) & 31;
+	n = flags & B::MIRROR_Y ? y - y0 + 3 : l.heights[tr] - 1 - (y - y0) + 3;
+	row = (n + n / 7) & 31;
+}
+
+static int mismatches(const B::Layout& l, BROSE9323& d) {
+	int bad = 0;
+	for (int y = 0; y < d.height(); y++) {
+		for (int x = 0; x < d.width(); x++) {
+			int panel, col, row;
+			model(l, x, y, panel, col, row);
+			if (panelSim().dots[panel][col][row] != d.getBufferPixel(x, y)) bad++;
+		}
+	}
+	return bad;
+}
+
+template <const B::Layout& L>
+static void check(void) {
+	BROSE9323Tiled<L> d;
+	const int w = d.width(), h = d.height();
+
+	// No two dots share a coil
+	std::set<int> coils;
+	for (int y = 0; y < h; y++) {
+		for (int x = 0; x < w; x++) {
+			int panel, col, row;
+			model(L, x, y, panel, col, row);
+			coils.insert(panel << 10 | col << 5 | row);
+		}
+	}
+	TEST_ASSERT_EQUAL(w * h, coils.size());
+
+	d.begin();
+	d.fillScreen(0);
+	simShow(d, true);
+	randomSeed(3);
+	for (uint16_t f = 0; f < 300; f++) {
+		const uint8_t n = random(60);
+		for (uint8_t i = 0; i < n; i++) d.drawPixel(random(w), random(h), random(2));
+		if (f % 50 == 0) d.fillRect(random(w), random(h), 20, 9, random(2));
+		simShow(d);
+		TEST_ASSERT_EQUAL(0, mismatches(L, d));
+	}
+	TEST_ASSERT_EQUAL(0, panelSim().bad_data);
+
+	d.setDirect(true);
+	d.fillScreen(1);
+	d.drawPixel(5, h - 1, 0);
+	TEST_ASSERT_EQUAL(0, mismatches(L, d));
+	d.setDirect(false);
+}
+
+static void test_row(void) {
+	check<row>();
+}
+
+#ifndef BROSE9323_COLUMN_MAJOR
+static void test_wall(void) {
+	check<wall>();
+}
+
+static void test_stack(void) {
+	check<stack>();
+}
+
+static void test_mixed(void) {
+	check<mixed>();
+}
+#endif
+
+// A single row of equal panels addresses as BROSE9323Fixed does
+static void test_same_as_fixed(void) {
+	BROSE9323Tiled<three> d;
+	for (int x = 0; x < 84; x++) {
+		for (int y = 0; y < 16; y++) {
+			int panel, col, row, p, c, r;
+			model(three, x, y, panel, col, row);
+			PanelSim::address(x, y, 84, 16, 28, p, c, r);
+			TEST_ASSERT_EQUAL(p << 10 | c << 5 | r, panel << 10 | col << 5 | row);
+		}
+	}
+	d.begin();
+	d.fillScreen(0);
+	simShow(d, true);
+	d.fillRect(3, 2, 50, 9, 1);
+	d.drawFastHLine(0, 15, 84, 1);
+	simShow(d);
+	TEST_ASSERT_EQUAL(0, panelSim().mismatches(d));
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_row);
+#ifndef BROSE9323_COLUMN_MAJOR
+	RUN_TEST(test_wall);
+	RUN_TEST(test_stack);
+	RUN_TEST(test_mixed);
+#endif
+	RUN_TEST(test_same_as_fixed);
+	return UNITY_END();
+}